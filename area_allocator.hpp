@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 // Forward declaration
 class AreaAllocatorBase;
@@ -11,7 +14,20 @@ class AreaAllocatorBase;
 // Thread-local storage for current allocator context
 extern thread_local AreaAllocatorBase *current_area_allocator;
 
-// Base class for area allocators
+// Base class for area allocators.
+//
+// Two additions over the plain bump pointer:
+//  - Checkpoints: mark() captures the bump position and rewind(mark)
+//    reclaims everything allocated after it, so a nested scope (parse a
+//    frame inside handling a request) can give its suballocations back
+//    without resetting the whole area. Strictly LIFO - rewinding
+//    invalidates every allocation made after the mark, and marks taken
+//    after it.
+//  - Overflow chaining: when the fixed pool runs out, allocation moves to
+//    a chained heap block (sized at least like the pool) instead of
+//    throwing bad_alloc and killing the connection. Chain blocks are kept
+//    across reset() so a workload that overflowed once does not reallocate
+//    every iteration; chain depth is tracked as a sizing signal.
 class AreaAllocatorBase {
 protected:
   char *memory_pool;
@@ -21,31 +37,83 @@ protected:
   size_t allocation_count;
   const char *area_name;
 
+  struct OverflowBlock {
+    std::unique_ptr<char[]> memory;
+    size_t size = 0;
+    size_t offset = 0;
+  };
+  // Block 0 is the fixed pool; block i (i >= 1) is overflow_chain[i - 1]
+  std::vector<OverflowBlock> overflow_chain;
+  size_t active_block = 0;
+  size_t peak_chain_depth = 0;
+
 public:
   AreaAllocatorBase(char *pool, size_t size, const char *name)
       : memory_pool(pool), pool_size(size), current_offset(0), peak_usage(0),
         allocation_count(0), area_name(name) {}
 
+  // Checkpoint token for mark()/rewind()
+  struct Checkpoint {
+    size_t block = 0;
+    size_t offset = 0;
+    size_t count = 0;
+  };
+
   // Allocate raw memory
   void *allocate_raw(size_t size,
                      size_t alignment = alignof(std::max_align_t)) {
-    // Align the current offset
-    size_t aligned_offset = (current_offset + alignment - 1) & ~(alignment - 1);
-
-    if (aligned_offset + size > pool_size) {
-      // Area overflow - this is a critical error in our design
-      throw std::bad_alloc();
+    for (;;) {
+      char *base;
+      size_t capacity;
+      size_t offset;
+      if (active_block == 0) {
+        base = memory_pool;
+        capacity = pool_size;
+        offset = current_offset;
+      } else {
+        OverflowBlock &block = overflow_chain[active_block - 1];
+        base = block.memory.get();
+        capacity = block.size;
+        offset = block.offset;
+      }
+
+      // Align the current offset
+      size_t aligned_offset = (offset + alignment - 1) & ~(alignment - 1);
+
+      if (aligned_offset + size <= capacity) {
+        if (active_block == 0) {
+          current_offset = aligned_offset + size;
+        } else {
+          overflow_chain[active_block - 1].offset = aligned_offset + size;
+        }
+        allocation_count++;
+
+        size_t used = get_used_size();
+        if (used > peak_usage) {
+          peak_usage = used;
+        }
+
+        return base + aligned_offset;
+      }
+
+      // Overflow: move on to the next chained block, reusing one kept from
+      // an earlier overflow or growing the chain
+      if (active_block < overflow_chain.size()) {
+        active_block++;
+        overflow_chain[active_block - 1].offset = 0;
+      } else {
+        size_t block_size =
+            pool_size > size + alignment ? pool_size : size + alignment;
+        OverflowBlock block;
+        block.memory.reset(new char[block_size]);
+        block.size = block_size;
+        overflow_chain.push_back(std::move(block));
+        active_block = overflow_chain.size();
+        if (active_block > peak_chain_depth) {
+          peak_chain_depth = active_block;
+        }
+      }
     }
-
-    void *ptr = memory_pool + aligned_offset;
-    current_offset = aligned_offset + size;
-    allocation_count++;
-
-    if (current_offset > peak_usage) {
-      peak_usage = current_offset;
-    }
-
-    return ptr;
   }
 
   // Deallocate - no-op for area allocators
@@ -55,21 +123,56 @@ public:
     (void)size;
   }
 
-  // Reset the entire area
+  // Capture the current bump position for a later rewind()
+  Checkpoint mark() const {
+    size_t offset = active_block == 0 ? current_offset
+                                      : overflow_chain[active_block - 1].offset;
+    return Checkpoint{active_block, offset, allocation_count};
+  }
+
+  // Reclaim everything allocated since the matching mark(). LIFO only:
+  // the caller promises nothing allocated before the mark points into the
+  // region being reclaimed
+  void rewind(const Checkpoint &checkpoint) {
+    for (size_t i = checkpoint.block; i < overflow_chain.size(); i++) {
+      overflow_chain[i].offset = 0;
+    }
+    if (checkpoint.block == 0) {
+      current_offset = checkpoint.offset;
+    } else {
+      overflow_chain[checkpoint.block - 1].offset = checkpoint.offset;
+    }
+    active_block = checkpoint.block;
+    allocation_count = checkpoint.count;
+  }
+
+  // Reset the entire area (chain blocks are kept for reuse)
   void reset() {
     current_offset = 0;
+    for (OverflowBlock &block : overflow_chain) {
+      block.offset = 0;
+    }
+    active_block = 0;
     allocation_count = 0;
     // Keep peak_usage for statistics
   }
 
   // Get statistics
-  size_t get_used_size() const { return current_offset; }
+  size_t get_used_size() const {
+    size_t used = current_offset;
+    for (size_t i = 0; i < active_block; i++) {
+      used += overflow_chain[i].offset;
+    }
+    return used;
+  }
   size_t get_peak_usage() const { return peak_usage; }
   size_t get_total_size() const { return pool_size; }
   size_t get_allocation_count() const { return allocation_count; }
+  size_t get_chain_depth() const { return overflow_chain.size(); }
+  size_t get_peak_chain_depth() const { return peak_chain_depth; }
   const char *get_name() const { return area_name; }
   double get_usage_percentage() const {
-    return pool_size > 0 ? (double)current_offset / pool_size * 100.0 : 0.0;
+    return pool_size > 0 ? (double)get_used_size() / pool_size * 100.0 : 0.0;
   }
 };
 
@@ -90,7 +193,11 @@ private:
   AreaAllocatorBase *area;
 
 public:
-  // Default constructor uses thread-local area
+  // Default constructor uses thread-local area. With no context in scope
+  // the allocator falls back to the heap, so containers built outside a
+  // WITH_AREA_ALLOCATOR region (long-lived connection state, globals)
+  // behave exactly like their std counterparts - only allocations made
+  // under an active context land in the area.
   AreaAllocator() : area(current_area_allocator) {}
 
   // Explicit constructor with specific area
@@ -105,19 +212,23 @@ public:
 
   // Allocate memory for n objects of type T
   pointer allocate(size_type n) {
+    size_t size = n * sizeof(T);
     if (!area) {
-      throw std::bad_alloc(); // No area allocator set
+      // No context: plain heap allocation, freed in deallocate()
+      return static_cast<pointer>(::operator new(size));
     }
 
-    size_t size = n * sizeof(T);
     void *ptr = area->allocate_raw(size, alignof(T));
     return static_cast<pointer>(ptr);
   }
 
-  // Deallocate memory (no-op for area allocators)
+  // Deallocate memory (no-op for area allocations, real free for the
+  // heap-fallback path)
   void deallocate(pointer ptr, size_type n) {
     if (area) {
       area->deallocate_raw(ptr, n * sizeof(T));
+    } else {
+      ::operator delete(ptr);
     }
   }
 
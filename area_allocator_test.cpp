@@ -155,40 +155,37 @@ void test_area_overflow() {
 
   LOG("Temp area size: ", temp_area->get_total_size(), " bytes");
 
-  try {
-    // Try to allocate more than the area size
-    size_t large_size = temp_area->get_total_size() + 1000;
-    LOG("Attempting to allocate ", large_size, " bytes (should fail)...");
-
-    char *ptr = static_cast<char *>(temp_area->allocate_raw(large_size));
-    LOG("ERROR: Allocation should have failed but succeeded!");
-
-  } catch (const std::bad_alloc &e) {
-    LOG("Good: Allocation correctly failed with bad_alloc");
+  // An allocation bigger than the fixed pool moves to an overflow chain
+  // block instead of throwing
+  size_t large_size = temp_area->get_total_size() + 1000;
+  LOG("Attempting to allocate ", large_size, " bytes (should chain)...");
+
+  char *ptr = static_cast<char *>(temp_area->allocate_raw(large_size));
+  if (ptr && temp_area->get_chain_depth() >= 1) {
+    LOG("Good: Oversized allocation chained, depth ",
+        temp_area->get_chain_depth());
+  } else {
+    LOG("ERROR: Oversized allocation did not grow the chain!");
   }
 
-  // Try gradual overflow
+  // Gradual overflow: keep allocating past several pool-sizes worth and
+  // watch the chain grow rather than a bad_alloc surface
+  temp_area->reset();
   LOG("Testing gradual overflow...");
+  size_t target = temp_area->get_total_size() * 3;
   size_t allocated = 0;
   int allocation_count = 0;
 
-  try {
-    while (true) {
-      temp_area->allocate_raw(1000);
-      allocated += 1000;
-      allocation_count++;
-
-      if (allocation_count % 10 == 0) {
-        LOG("  Allocated ", allocated, " bytes in ", allocation_count,
-            " chunks");
-      }
-    }
-  } catch (const std::bad_alloc &e) {
-    LOG("Overflow detected after allocating ", allocated, " bytes in ",
-        allocation_count, " chunks");
-    LOG("Area usage: ", temp_area->get_usage_percentage(), "%");
+  while (allocated < target) {
+    temp_area->allocate_raw(1000);
+    allocated += 1000;
+    allocation_count++;
   }
 
+  LOG("Allocated ", allocated, " bytes in ", allocation_count,
+      " chunks, chain depth ", temp_area->get_chain_depth());
+  LOG("Area usage: ", temp_area->get_usage_percentage(), "%");
+
   cleanup_poller_memory();
 }
 
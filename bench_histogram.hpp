@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Fixed-bucket latency histogram for the in-tree benchmarks (http_bench,
+// websocket_perf_test): 10us resolution across a 1 second span (800KB,
+// allocated once). Unlike the event loop's power-of-two LatencyHistogram
+// this keeps enough resolution for meaningful tail percentiles. Single
+// writer, no atomics - the benchmarks record from the poller thread only.
+struct BenchHistogram {
+  static constexpr uint64_t BUCKET_US = 10;
+  static constexpr size_t BUCKETS = 100 * 1000; // covers 0..1s
+
+  std::vector<uint64_t> buckets = std::vector<uint64_t>(BUCKETS, 0);
+  uint64_t count = 0;
+  uint64_t sum_us = 0;
+  uint64_t max_us = 0;
+
+  void record(uint64_t us) {
+    size_t index = us / BUCKET_US;
+    if (index >= BUCKETS) {
+      index = BUCKETS - 1;
+    }
+    buckets[index]++;
+    count++;
+    sum_us += us;
+    if (us > max_us) {
+      max_us = us;
+    }
+  }
+
+  void reset() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    sum_us = 0;
+    max_us = 0;
+  }
+
+  // Upper bound of the bucket holding the p-th percentile sample
+  uint64_t percentileUs(double p) const {
+    if (count == 0) {
+      return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(p * count);
+    if (target >= count) {
+      target = count - 1;
+    }
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+      cumulative += buckets[i];
+      if (cumulative > target) {
+        return (i + 1) * BUCKET_US;
+      }
+    }
+    return max_us;
+  }
+};
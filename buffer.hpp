@@ -1,15 +1,123 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
-#include <list>
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <vector>
 
+// Byte buffer backed by a ring of fixed-size slabs. Slabs are drawn from a
+// process-wide freelist pool, so steady-state traffic recycles the same
+// memory instead of hitting the heap for every message. A consumed-bytes
+// cursor (consume()) lets the socket write path advance past sent bytes
+// without copying or shifting anything, and readers that genuinely need flat
+// bytes can ask for them with contiguous() - compaction only happens when the
+// requested range actually spans a slab boundary.
 class Buffer {
+public:
+  static constexpr size_t SLAB_SIZE = 100 * 1024;
+
+  // One contiguous readable region (always within a single slab)
+  struct Slice {
+    const char *data;
+    size_t size;
+  };
+
 private:
-  static constexpr size_t BLOCK_SIZE = 100 * 1024;
-  std::list<std::vector<char>> blocks_;
+  struct Slab {
+    char data[SLAB_SIZE];
+    Slab *next; // freelist link while pooled
+  };
+
+  // Process-wide slab pool shared by all buffers on all threads; released
+  // slabs go back on the freelist (up to a cap) instead of being freed
+  struct SlabPool {
+    static constexpr size_t MAX_FREE = 64; // retained memory cap (~6.4MB)
+
+    std::mutex mutex;
+    Slab *free_list = nullptr;
+    size_t free_count = 0;
+
+    Slab *acquire() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_list) {
+          Slab *slab = free_list;
+          free_list = slab->next;
+          free_count--;
+          return slab;
+        }
+      }
+      return new Slab;
+    }
+
+    void release(Slab *slab) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_count < MAX_FREE) {
+          slab->next = free_list;
+          free_list = slab;
+          free_count++;
+          return;
+        }
+      }
+      delete slab;
+    }
+  };
+
+  static SlabPool &slabPool() {
+    static SlabPool pool;
+    return pool;
+  }
+
+  std::deque<Slab *> slabs_;
   size_t total_size_ = 0;
+  size_t head_offset_ = 0; // consumed bytes within the front slab
+  size_t tail_size_ = 0;   // filled bytes within the back slab
+  std::vector<char> contig_scratch_;
+
+  // Filled bytes of slab i (every slab except the back one is full)
+  size_t slabFill(size_t i) const {
+    return (i + 1 == slabs_.size()) ? tail_size_ : SLAB_SIZE;
+  }
 
 public:
+  Buffer() = default;
+  ~Buffer() { clear(); }
+
+  Buffer(const Buffer &other) { append(other); }
+  Buffer &operator=(const Buffer &other) {
+    if (this != &other) {
+      clear();
+      append(other);
+    }
+    return *this;
+  }
+
+  Buffer(Buffer &&other) noexcept
+      : slabs_(std::move(other.slabs_)), total_size_(other.total_size_),
+        head_offset_(other.head_offset_), tail_size_(other.tail_size_) {
+    other.slabs_.clear();
+    other.total_size_ = 0;
+    other.head_offset_ = 0;
+    other.tail_size_ = 0;
+  }
+  Buffer &operator=(Buffer &&other) noexcept {
+    if (this != &other) {
+      clear();
+      slabs_ = std::move(other.slabs_);
+      total_size_ = other.total_size_;
+      head_offset_ = other.head_offset_;
+      tail_size_ = other.tail_size_;
+      other.slabs_.clear();
+      other.total_size_ = 0;
+      other.head_offset_ = 0;
+      other.tail_size_ = 0;
+    }
+    return *this;
+  }
+
   // Simple append operation
   void append(const char *data, size_t len) {
     if (len == 0)
@@ -19,51 +127,108 @@ public:
     const char *current = data;
 
     while (remaining > 0) {
-      // Get or create current block
-      if (blocks_.empty() || blocks_.back().size() >= BLOCK_SIZE) {
-        blocks_.emplace_back();
-        blocks_.back().reserve(BLOCK_SIZE);
+      // Get a fresh slab from the pool once the back one is full
+      if (slabs_.empty() || tail_size_ == SLAB_SIZE) {
+        slabs_.push_back(slabPool().acquire());
+        tail_size_ = 0;
       }
 
-      // Calculate how much we can write to current block
-      size_t space_in_block = BLOCK_SIZE - blocks_.back().size();
-      size_t to_write = std::min(remaining, space_in_block);
-
-      // Append data to current block
-      blocks_.back().insert(blocks_.back().end(), current, current + to_write);
+      size_t to_write = std::min(remaining, SLAB_SIZE - tail_size_);
+      memcpy(slabs_.back()->data + tail_size_, current, to_write);
 
+      tail_size_ += to_write;
       current += to_write;
       remaining -= to_write;
       total_size_ += to_write;
     }
   }
 
-  // Get byte at specific position
+  // Append the remaining contents of another buffer slice-wise (no
+  // byte-at-a-time copying)
+  void append(const Buffer &other) {
+    for (size_t i = 0; i < other.sliceCount(); ++i) {
+      Slice slice = other.sliceAt(i);
+      append(slice.data, slice.size);
+    }
+  }
+
+  // Append data from containers with .data() and .size()
+  template <typename Container> void append(const Container &container) {
+    append(container.data(), container.size());
+  }
+
+  // Get byte at specific position (relative to the unconsumed head); O(1)
+  // now that slabs are fixed-size and the ring is randomly accessible
   char getAt(size_t pos) const {
     if (pos >= total_size_) {
       return 0; // Or throw exception if preferred
     }
-
-    size_t block_idx = pos / BLOCK_SIZE;
-    auto it = blocks_.begin();
-    std::advance(it, block_idx);
-    size_t block_pos = pos % BLOCK_SIZE;
-
-    return (*it)[block_pos];
+    size_t offset = pos + head_offset_;
+    return slabs_[offset / SLAB_SIZE]->data[offset % SLAB_SIZE];
   }
 
-  // Set byte at specific position
+  // Set byte at specific position (relative to the unconsumed head)
   void setAt(size_t pos, char value) {
     if (pos >= total_size_) {
       return; // Or throw exception if preferred
     }
+    size_t offset = pos + head_offset_;
+    slabs_[offset / SLAB_SIZE]->data[offset % SLAB_SIZE] = value;
+  }
+
+  // Drop len bytes from the front without copying or shifting the remaining
+  // data - whole slabs go back to the pool, a partial slab just advances the
+  // head cursor. This is what makes partial writev sends cheap to track.
+  void consume(size_t len) {
+    while (len > 0 && !slabs_.empty()) {
+      size_t available = slabFill(0) - head_offset_;
+      if (len >= available) {
+        slabPool().release(slabs_.front());
+        slabs_.pop_front();
+        head_offset_ = 0;
+        total_size_ -= available;
+        len -= available;
+      } else {
+        head_offset_ += len;
+        total_size_ -= len;
+        len = 0;
+      }
+    }
+    if (slabs_.empty()) {
+      tail_size_ = 0;
+    }
+  }
 
-    size_t block_idx = pos / BLOCK_SIZE;
-    auto it = blocks_.begin();
-    std::advance(it, block_idx);
-    size_t block_pos = pos % BLOCK_SIZE;
+  // The contiguous readable region at the front, without copying
+  Slice peek() const {
+    if (slabs_.empty()) {
+      return Slice{nullptr, 0};
+    }
+    return sliceAt(0);
+  }
 
-    (*it)[block_pos] = value;
+  // Flat pointer to the first len unconsumed bytes. Free when they already
+  // sit in one slab; otherwise they are compacted into a scratch area, so
+  // only parsers that truly need flat bytes pay for the copy. The pointer is
+  // valid until the next append/consume/contiguous call.
+  const char *contiguous(size_t len) {
+    if (len > total_size_) {
+      return nullptr;
+    }
+    Slice front = peek();
+    if (len <= front.size) {
+      return front.data;
+    }
+
+    contig_scratch_.resize(len);
+    size_t copied = 0;
+    for (size_t i = 0; copied < len; ++i) {
+      Slice slice = sliceAt(i);
+      size_t to_copy = std::min(slice.size, len - copied);
+      memcpy(contig_scratch_.data() + copied, slice.data, to_copy);
+      copied += to_copy;
+    }
+    return contig_scratch_.data();
   }
 
   // Get total size
@@ -71,18 +236,24 @@ public:
 
   // Clear all data
   void clear() {
-    blocks_.clear();
+    for (Slab *slab : slabs_) {
+      slabPool().release(slab);
+    }
+    slabs_.clear();
     total_size_ = 0;
+    head_offset_ = 0;
+    tail_size_ = 0;
   }
 
-  // Append data from containers with .data() and .size()
-  template <typename Container> void append(const Container &container) {
-    append(container.data(), container.size());
-  }
+  // Readable regions for scatter-gather I/O: slice i is the filled part of
+  // slab i, with the front slice starting at the consume cursor
+  size_t sliceCount() const { return slabs_.size(); }
 
-  // Get number of blocks
-  size_t blockCount() const { return blocks_.size(); }
+  Slice sliceAt(size_t i) const {
+    size_t start = (i == 0) ? head_offset_ : 0;
+    return Slice{slabs_[i]->data + start, slabFill(i) - start};
+  }
 
-  // Get block size
-  static constexpr size_t blockSize() { return BLOCK_SIZE; }
-};
\ No newline at end of file
+  // Get slab size
+  static constexpr size_t slabSize() { return SLAB_SIZE; }
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include "buffer_view.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+// Ordered span-of-spans over non-owning byte segments: the zero-copy way to
+// hand scattered input (pooled recv areas, leftover partial-message bytes +
+// the new chunk) to a parser without first flattening it into one
+// allocation. Converts to iovec[] for scatter-gather syscalls, and Cursor
+// iterates bytes across segment boundaries for parsers that step through a
+// wire format. Segments are views - the chain is only valid as long as the
+// memory behind them is.
+struct BufferChain {
+  std::vector<BufferView> segments = {};
+  size_t total_size = 0;
+
+  BufferChain() = default;
+
+  // Implicit on purpose: any BufferView is a single-segment chain
+  BufferChain(const BufferView &view) { append(view); }
+
+  void append(const BufferView &view) {
+    if (!view.empty()) {
+      segments.push_back(view);
+      total_size += view.size;
+    }
+  }
+
+  void append(const char *data, size_t len) { append(BufferView{data, len}); }
+
+  size_t size() const { return total_size; }
+  bool empty() const { return total_size == 0; }
+
+  size_t segmentCount() const { return segments.size(); }
+  const BufferView &segmentAt(size_t i) const { return segments[i]; }
+
+  // Fill up to max iovec entries (one per segment); returns entries filled
+  size_t fillIovec(struct iovec *iov, size_t max) const {
+    size_t count = 0;
+    for (const BufferView &segment : segments) {
+      if (count >= max) {
+        break;
+      }
+      iov[count].iov_base = segment.data;
+      iov[count].iov_len = segment.size;
+      count++;
+    }
+    return count;
+  }
+
+  // Byte at pos, walking segments (prefer Cursor for sequential access)
+  char byteAt(size_t pos) const {
+    for (const BufferView &segment : segments) {
+      if (pos < segment.size) {
+        return segment.data[pos];
+      }
+      pos -= segment.size;
+    }
+    return 0;
+  }
+
+  // Flatten into a string - the escape hatch for consumers that still need
+  // contiguous bytes; one copy, so use sparingly. Templated so both
+  // std::string and the (possibly area-allocated) String alias work.
+  template <typename Str> void appendTo(Str &out) const {
+    for (const BufferView &segment : segments) {
+      out.append(segment.data, segment.size);
+    }
+  }
+
+  // Cheap forward byte cursor across segment boundaries
+  struct Cursor {
+    const BufferChain *chain;
+    size_t segment_index = 0;
+    size_t segment_offset = 0;
+    size_t consumed = 0;
+
+    explicit Cursor(const BufferChain &c) : chain(&c) {}
+
+    size_t remaining() const { return chain->total_size - consumed; }
+
+    // Next byte; caller checks remaining() first
+    uint8_t next() {
+      const BufferView &segment = chain->segments[segment_index];
+      uint8_t byte = static_cast<uint8_t>(segment.data[segment_offset]);
+      advance(1);
+      return byte;
+    }
+
+    // Copy len bytes out, segment-wise; caller checks remaining() first
+    void read(void *dst, size_t len) {
+      char *out = static_cast<char *>(dst);
+      while (len > 0) {
+        const BufferView &segment = chain->segments[segment_index];
+        size_t to_copy = segment.size - segment_offset;
+        if (to_copy > len) {
+          to_copy = len;
+        }
+        memcpy(out, segment.data + segment_offset, to_copy);
+        out += to_copy;
+        len -= to_copy;
+        advance(to_copy);
+      }
+    }
+
+    void skip(size_t len) {
+      while (len > 0) {
+        const BufferView &segment = chain->segments[segment_index];
+        size_t step = segment.size - segment_offset;
+        if (step > len) {
+          step = len;
+        }
+        len -= step;
+        advance(step);
+      }
+    }
+
+  private:
+    void advance(size_t len) {
+      segment_offset += len;
+      consumed += len;
+      while (segment_index < chain->segments.size() &&
+             segment_offset == chain->segments[segment_index].size) {
+        segment_index++;
+        segment_offset = 0;
+      }
+    }
+  };
+};
@@ -29,11 +29,24 @@ int main() {
   }
   std::cout << "\n\n";
 
-  // Example 5: Append more data to demonstrate block creation
-  std::string long_string(2000, 'X'); // This will create multiple blocks
+  // Example 5: Append more data
+  std::string long_string(2000, 'X');
   buf.append(long_string.data(), long_string.size());
 
-  std::cout << "Total buffer size: " << buf.size() << " bytes\n";
+  std::cout << "Total buffer size: " << buf.size() << " bytes\n\n";
+
+  // Example 6: Consume bytes from the front (cursor advance, no copying)
+  buf.consume(7);
+  std::cout << "After consuming 7 bytes, size: " << buf.size()
+            << ", first byte: " << buf.getAt(0) << "\n\n";
+
+  // Example 7: Peek at the contiguous front region without copying
+  Buffer::Slice front = buf.peek();
+  std::cout << "Front slice holds " << front.size << " contiguous bytes\n\n";
+
+  // Example 8: Get a flat pointer (compacts only across slab boundaries)
+  const char *flat = buf.contiguous(6);
+  std::cout << "First 6 bytes flat: " << std::string(flat, 6) << "\n";
 
   return 0;
 }
\ No newline at end of file
@@ -107,6 +107,16 @@ using StringStream = std::stringstream;
 using IStringStream = std::istringstream;
 using OStringStream = std::ostringstream;
 
+// std::hash only covers std::allocator strings; hash the area-allocated
+// String by content so it keys HashMap/HashSet like a std::string would
+namespace std {
+template <> struct hash<String> {
+    size_t operator()(const String& s) const noexcept {
+        return hash<string_view>()(string_view(s.data(), s.size()));
+    }
+};
+}
+
 #else
 
 // Standard STL containers (fallback)
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "http_client.hpp"
+#include "log.hpp"
+#include "poller.hpp"
+#include "socket.hpp"
+#include <array>
+#include <coroutine>
+#include <cstdlib>
+#include <vector>
+
+// C++20 coroutine layer over Poller, Socket, and HttpClient. Multi-step
+// flows written with callbacks allocate a lambda per step and scatter their
+// state across captures; a coroutine keeps the whole flow's state in one
+// frame and the compiler's state-machine transformation replaces the
+// per-step std::function churn:
+//
+//   Coro session(Socket &sock, HttpClient &client, Poller &poller) {
+//     String line = co_await coroRead(sock);
+//     HttpResponse res = co_await coroGet(client, "http://api/" + line);
+//     co_await coroSleep(poller, 100);
+//     sock.write(res.body);
+//   }
+//
+// Everything here runs on the poller thread: awaitables arm the existing
+// callback hooks and resume the coroutine through poller->post(), so the
+// installing callback has fully returned before the coroutine runs again
+// (resuming inline would let the coroutine re-assign the very callback
+// whose invocation it is executing inside).
+//
+// MEMORY ALLOCATION: coroutine frames recycle through a thread-local
+// size-bucketed freelist, so at steady state launching a coroutine costs no
+// malloc. (The bump areas in poller_memory.hpp only free by resetting the
+// whole area; frames suspend across awaits with arbitrary lifetimes, so
+// they get their own freelist instead.)
+struct CoroFramePool {
+  static constexpr size_t GRANULARITY = 64;
+  static constexpr size_t BUCKETS = 32; // up to 2KB inline; bigger uses malloc
+
+  // Freelists are intrusive: a freed frame's first pointer links to the next
+  std::array<void *, BUCKETS> freelists = {};
+
+  static CoroFramePool &instance() {
+    static thread_local CoroFramePool pool;
+    return pool;
+  }
+
+  static size_t bucketFor(size_t size) {
+    return (size + GRANULARITY - 1) / GRANULARITY - 1;
+  }
+
+  void *allocate(size_t size) {
+    size_t bucket = bucketFor(size);
+    if (bucket >= BUCKETS) {
+      return std::malloc(size);
+    }
+    void *block = freelists[bucket];
+    if (block) {
+      freelists[bucket] = *static_cast<void **>(block);
+      return block;
+    }
+    return std::malloc((bucket + 1) * GRANULARITY);
+  }
+
+  void release(void *ptr, size_t size) {
+    size_t bucket = bucketFor(size);
+    if (bucket >= BUCKETS) {
+      std::free(ptr);
+      return;
+    }
+    *static_cast<void **>(ptr) = freelists[bucket];
+    freelists[bucket] = ptr;
+  }
+
+  ~CoroFramePool() {
+    for (void *block : freelists) {
+      while (block) {
+        void *next = *static_cast<void **>(block);
+        std::free(block);
+        block = next;
+      }
+    }
+  }
+};
+
+// Fire-and-forget coroutine: call it, let it run; it cleans its own frame
+// up when it finishes. The handle is not owning - flows that must outlive
+// their caller keep whatever state they need in the frame itself.
+struct Coro {
+  struct promise_type {
+    Coro get_return_object() { return {}; }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {
+      LOG_ERROR("Unhandled exception escaped a coroutine");
+    }
+
+    static void *operator new(size_t size) {
+      return CoroFramePool::instance().allocate(size);
+    }
+    static void operator delete(void *ptr, size_t size) {
+      CoroFramePool::instance().release(ptr, size);
+    }
+  };
+};
+
+// co_await coroSleep(poller, ms) - suspend for ms milliseconds on a poller
+// timer
+struct SleepAwaitable {
+  Poller &poller;
+  uint32_t ms;
+
+  bool await_ready() const { return ms == 0; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    poller.setTimeout(ms, [handle]() { handle.resume(); });
+  }
+  void await_resume() {}
+};
+
+inline SleepAwaitable coroSleep(Poller &poller, uint32_t ms) {
+  return SleepAwaitable{poller, ms};
+}
+
+// co_await coroRead(socket) - suspend until the next chunk of data arrives
+// and resume with a copy of it. Re-arms nothing: each read installs onData
+// for exactly one delivery, so a loop of co_await coroRead(...) reads
+// chunk by chunk.
+struct ReadAwaitable {
+  Socket &socket;
+  std::string data = "";
+
+  bool await_ready() const { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    // The awaitable lives in the suspended frame, so `this` stays valid
+    // until resume
+    socket.onData = [this, handle](Socket &sock, const BufferView &view) {
+      data.assign(view.data, view.size);
+      // Really one-shot: uninstall before resuming. Once the coroutine
+      // runs on, this frame (and `this`) can be gone, and a stale handler
+      // firing on the next chunk would write through a dangling pointer.
+      // Reassigning destroys this lambda's captures, so take local copies
+      // first and touch nothing captured afterwards.
+      std::coroutine_handle<> resume_handle = handle;
+      Poller *poller = sock.poller;
+      sock.onData = [](Socket &, const BufferView &) {};
+      poller->post([resume_handle]() { resume_handle.resume(); });
+    };
+  }
+  std::string await_resume() { return std::move(data); }
+};
+
+inline ReadAwaitable coroRead(Socket &socket) { return ReadAwaitable{socket}; }
+
+// co_await coroGet(pool, url) - issue the GET through an HttpClientPool and
+// resume with the response (coroPost for request bodies). Going through the
+// pool rather than a bare HttpClient means sequential awaits reuse one
+// kept-alive connection, and the pool owns every socket lifetime question -
+// the coroutine only ever sees the finished HttpResponse.
+struct HttpAwaitable {
+  HttpClientPool &pool;
+  HttpMethod method;
+  std::string url;
+  std::string body = "";
+  HttpResponse response = {};
+
+  bool await_ready() const { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    auto callback = [this, handle](HttpResponse &res) {
+      response = res;
+      pool.poller->post([handle]() { handle.resume(); });
+    };
+    bool ok = method == HttpMethod::POST ? pool.post(url, body, callback)
+                                         : pool.get(url, callback);
+    if (!ok) {
+      response.status = HttpStatus::ERROR;
+      response.error_message = "failed to issue request";
+      pool.poller->post([handle]() { handle.resume(); });
+    }
+  }
+  HttpResponse await_resume() { return std::move(response); }
+};
+
+inline HttpAwaitable coroGet(HttpClientPool &pool, const std::string &url) {
+  return HttpAwaitable{pool, HttpMethod::GET, url};
+}
+
+inline HttpAwaitable coroPost(HttpClientPool &pool, const std::string &url,
+                              const std::string &body) {
+  return HttpAwaitable{pool, HttpMethod::POST, url, body};
+}
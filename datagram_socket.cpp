@@ -0,0 +1,218 @@
+#include "datagram_socket.hpp"
+#include "log.hpp"
+#include "poller.hpp"
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+DatagramSocket::DatagramSocket() : Pollable() {
+  type = PollableType::DATAGRAM;
+
+  recv_slab.reset(new char[BATCH_SIZE * DATAGRAM_MAX]);
+  send_slab.reset(new char[BATCH_SIZE * DATAGRAM_MAX]);
+
+  // Wire the scatter-gather headers to the slab once; recvmmsg rewrites
+  // only msg_len and the sender addresses between calls
+  for (size_t i = 0; i < BATCH_SIZE; i++) {
+    recv_iovecs[i].iov_base = recv_slab.get() + i * DATAGRAM_MAX;
+    recv_iovecs[i].iov_len = DATAGRAM_MAX;
+    recv_headers[i].msg_hdr.msg_iov = &recv_iovecs[i];
+    recv_headers[i].msg_hdr.msg_iovlen = 1;
+    recv_headers[i].msg_hdr.msg_name = &recv_addrs[i];
+  }
+
+  onEvent = [this](short revents) {
+    if (file_descriptor < 0) {
+      return;
+    }
+    if (revents & POLLIN) {
+      drainDatagrams();
+      if (file_descriptor < 0) {
+        return; // a batch callback stopped the socket
+      }
+    }
+    if ((revents & POLLOUT) && send_count > 0) {
+      flushDatagrams();
+    }
+  };
+}
+
+bool DatagramSocket::bind(uint16_t port, bool reuse_port) {
+  file_descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  int opt = 1;
+  setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  if (reuse_port) {
+    setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+  }
+
+  // A drain that momentarily falls behind a burst should find the packets
+  // in the socket buffer, not dropped; ask for a deep one (the kernel caps
+  // this at net.core.rmem_max)
+  int rcvbuf = 4 * 1024 * 1024;
+  setsockopt(file_descriptor, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = INADDR_ANY;
+  addr.sin_port = htons(port);
+  if (::bind(file_descriptor, reinterpret_cast<struct sockaddr *>(&addr),
+             sizeof(addr)) < 0) {
+    LOG_ERROR("[DatagramSocket] Failed to bind port ", port, ": ",
+              strerror(errno));
+    close(file_descriptor);
+    file_descriptor = -1;
+    return false;
+  }
+
+  int flags = fcntl(file_descriptor, F_GETFL, 0);
+  fcntl(file_descriptor, F_SETFL, flags | O_NONBLOCK);
+  return true;
+}
+
+void DatagramSocket::drainDatagrams() {
+  for (;;) {
+    // Re-arm the fields the previous call let the kernel overwrite
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      recv_headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    int received = recvmmsg(file_descriptor, recv_headers.data(), BATCH_SIZE,
+                            0, nullptr);
+    if (received <= 0) {
+      if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+          errno != EINTR) {
+        LOG_ERROR("[DatagramSocket] recvmmsg failed: ", strerror(errno));
+      }
+      return;
+    }
+
+    size_t total_bytes = 0;
+    for (int i = 0; i < received; i++) {
+      recv_batch[i].view = BufferView{recv_slab.get() + i * DATAGRAM_MAX,
+                                      recv_headers[i].msg_len};
+      recv_batch[i].from = recv_addrs[i];
+      total_bytes += recv_headers[i].msg_len;
+    }
+    if (poller) {
+      poller->metrics.countBytesRead(total_bytes);
+    }
+
+    onDatagrams(*this, std::span<const Datagram>(
+                           recv_batch.data(), static_cast<size_t>(received)));
+    if (file_descriptor < 0) {
+      return;
+    }
+    // A short batch means the queue is (nearly) empty; one more call will
+    // hit EAGAIN, so save it
+    if (received < static_cast<int>(BATCH_SIZE)) {
+      return;
+    }
+  }
+}
+
+bool DatagramSocket::sendTo(const void *data, size_t size,
+                            const struct sockaddr_in &to) {
+  if (file_descriptor < 0 || size > DATAGRAM_MAX) {
+    return false;
+  }
+  if (send_count == BATCH_SIZE) {
+    flushDatagrams();
+    if (send_count == BATCH_SIZE) {
+      return false; // kernel backpressure; the ring stays full
+    }
+  }
+
+  size_t slot = (send_head + send_count) % BATCH_SIZE;
+  std::memcpy(send_slab.get() + slot * DATAGRAM_MAX, data, size);
+  send_lengths[slot] = static_cast<uint16_t>(size);
+  send_addrs[slot] = to;
+  send_count++;
+
+  // First queued packet arms POLLOUT; everything queued until that wakeup
+  // leaves in one sendmmsg
+  if (send_count == 1 && poller) {
+    poller->enablePollout(id);
+  }
+  return true;
+}
+
+void DatagramSocket::flushDatagrams() {
+  while (send_count > 0) {
+    size_t contiguous = BATCH_SIZE - send_head;
+    size_t count = send_count < contiguous ? send_count : contiguous;
+
+    // Headers are rebuilt per flush - the ring wraps, so iovecs can't be
+    // wired once like the receive side
+    std::array<struct mmsghdr, BATCH_SIZE> headers = {};
+    std::array<struct iovec, BATCH_SIZE> iovecs = {};
+    for (size_t i = 0; i < count; i++) {
+      size_t slot = send_head + i;
+      iovecs[i].iov_base = send_slab.get() + slot * DATAGRAM_MAX;
+      iovecs[i].iov_len = send_lengths[slot];
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+      headers[i].msg_hdr.msg_name = &send_addrs[slot];
+      headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    int sent = sendmmsg(file_descriptor, headers.data(),
+                        static_cast<unsigned int>(count), 0);
+    if (sent <= 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        if (poller) {
+          poller->enablePollout(id); // retry on the next wakeup
+        }
+      } else {
+        LOG_ERROR("[DatagramSocket] sendmmsg failed: ", strerror(errno));
+        send_count = 0; // drop the batch; the fd is in a bad state
+        send_head = 0;
+      }
+      return;
+    }
+
+    size_t total_bytes = 0;
+    for (int i = 0; i < sent; i++) {
+      total_bytes += send_lengths[send_head + i];
+    }
+    if (poller) {
+      poller->metrics.countBytesWritten(total_bytes);
+    }
+
+    send_head = (send_head + static_cast<size_t>(sent)) % BATCH_SIZE;
+    send_count -= static_cast<size_t>(sent);
+    if (static_cast<size_t>(sent) < count) {
+      if (poller) {
+        poller->enablePollout(id); // partial accept; finish on next wakeup
+      }
+      return;
+    }
+  }
+}
+
+void DatagramSocket::stop() {
+  if (file_descriptor < 0) {
+    return; // never started or already stopped
+  }
+  close(file_descriptor);
+  file_descriptor = -1;
+  send_count = 0;
+  send_head = 0;
+
+  if (onClose) {
+    onClose(*this);
+  }
+
+  if (poller) {
+    // Defer pool removal to the cleanup phase of the poller loop - the
+    // slot (and this object) stays alive until the current dispatch is done
+    Poller *owner = poller;
+    PollableID datagram_id = id;
+    owner->cleanupTasks.push_back(
+        [owner, datagram_id]() { owner->removePollable(datagram_id); });
+  }
+}
@@ -1,28 +1,132 @@
 #pragma once
+#include "inplace_function.hpp"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
-// Task represents a unit of work to be executed by the executor
-using Task = std::function<void()>;
+// Task represents a unit of work to be executed by the executor. Inline
+// storage (no heap allocation per task) and move-only - see
+// inplace_function.hpp.
+using Task = InplaceFunction<void()>;
 
-// Executor manages a thread pool for safely executing callbacks
+// Executor manages a thread pool for safely executing callbacks.
+//
+// Internals are work-stealing: each worker owns a bounded ring it pushes
+// and pops LIFO with plain atomics (no lock), and idle workers steal from
+// the opposite end FIFO with a CAS - so tasks that spawn tasks never touch
+// a lock, and hot workers never contend with each other. External
+// submissions (the poller thread) go through a small injection queue whose
+// mutex is held only for a push or a batch splice; workers drain it into
+// their local rings when they run dry. Tasks are heap-allocated pointers in
+// the rings, which keeps the steal race trivial: only the CAS winner ever
+// touches the task.
 class Executor {
 private:
+  // Chase-Lev deque of task pointers: owner pushes/pops at bottom (LIFO for
+  // cache locality), thieves CAS the top (FIFO, oldest first). Bounded so a
+  // full ring spills to the injection queue instead of reallocating under
+  // concurrent access.
+  struct WorkerQueue {
+    static constexpr size_t CAPACITY = 4096; // power of two
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    std::array<std::atomic<Task *>, CAPACITY> slots;
+    std::atomic<long long> top{0};
+    std::atomic<long long> bottom{0};
+
+    WorkerQueue() {
+      for (auto &slot : slots) {
+        slot.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    // Owner only
+    bool push(Task *task) {
+      long long b = bottom.load(std::memory_order_relaxed);
+      long long t = top.load(std::memory_order_acquire);
+      if (b - t >= static_cast<long long>(CAPACITY)) {
+        return false; // full - caller spills to the injection queue
+      }
+      slots[b & MASK].store(task, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Owner only, newest first
+    Task *pop() {
+      long long b = bottom.load(std::memory_order_relaxed) - 1;
+      bottom.store(b, std::memory_order_seq_cst);
+      long long t = top.load(std::memory_order_seq_cst);
+      if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr; // empty
+      }
+      Task *task = slots[b & MASK].load(std::memory_order_relaxed);
+      if (t == b) {
+        // Last element: race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1,
+                                         std::memory_order_seq_cst)) {
+          task = nullptr; // a thief won
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return task;
+    }
+
+    // Any thread, oldest first
+    Task *steal() {
+      long long t = top.load(std::memory_order_seq_cst);
+      long long b = bottom.load(std::memory_order_seq_cst);
+      if (t >= b) {
+        return nullptr; // empty
+      }
+      Task *task = slots[t & MASK].load(std::memory_order_relaxed);
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst)) {
+        return nullptr; // lost the race; never touch the pointer
+      }
+      return task;
+    }
+  };
+
   std::vector<std::thread> workers;
-  std::queue<Task> taskQueue;
-  mutable std::mutex queueMutex; // Make mutable for const methods
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+  // External submissions and ring overflow land here; workers refill their
+  // local ring from it in batches so the mutex is touched rarely
+  std::deque<Task *> injection;
+  std::mutex injectionMutex;
+
+  // Parking: workers sleep on the condition variable only after finding
+  // every queue empty; submitters notify only when someone is asleep
+  std::mutex sleepMutex;
   std::condition_variable condition;
+  std::atomic<int> sleepers{0};
+
+  std::atomic<size_t> pending{0};
   std::atomic<bool> running{false};
   size_t numThreads;
 
+  // Identifies the current thread's queue when a task submits more work
+  // (function-local statics so the header stays definition-free)
+  static Executor *&currentExecutor() {
+    static thread_local Executor *executor = nullptr;
+    return executor;
+  }
+  static size_t &currentWorkerIndex() {
+    static thread_local size_t index = 0;
+    return index;
+  }
+
 public:
   explicit Executor(size_t threadCount = std::thread::hardware_concurrency())
-      : numThreads(threadCount) {}
+      : numThreads(threadCount == 0 ? 1 : threadCount) {}
 
   ~Executor() { stop(); }
 
@@ -34,9 +138,12 @@ public:
 
     running.store(true);
 
-    // Create worker threads
+    queues.clear();
+    for (size_t i = 0; i < numThreads; ++i) {
+      queues.emplace_back(new WorkerQueue());
+    }
     for (size_t i = 0; i < numThreads; ++i) {
-      workers.emplace_back([this] { workerLoop(); });
+      workers.emplace_back([this, i] { workerLoop(i); });
     }
 
     return true;
@@ -49,7 +156,10 @@ public:
     }
 
     running.store(false);
-    condition.notify_all();
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      condition.notify_all();
+    }
 
     for (auto &worker : workers) {
       if (worker.joinable()) {
@@ -59,67 +169,155 @@ public:
 
     workers.clear();
 
-    // Clear remaining tasks
-    std::lock_guard<std::mutex> lock(queueMutex);
-    while (!taskQueue.empty()) {
-      taskQueue.pop();
+    // Drop remaining tasks
+    for (auto &queue : queues) {
+      Task *task;
+      while ((task = queue->steal()) != nullptr) {
+        delete task;
+      }
+    }
+    queues.clear();
+
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    for (Task *task : injection) {
+      delete task;
     }
+    injection.clear();
+    pending.store(0);
   }
 
-  // Submit a task for execution
+  // Submit a task for execution. On a worker thread this pushes to the
+  // local ring without locking; from outside it goes through the injection
+  // queue.
   void submit(Task task) {
     if (!running.load()) {
       return; // Executor not running
     }
 
+    Task *boxed = new Task(std::move(task));
+    pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (currentExecutor() == this && queues[currentWorkerIndex()]->push(boxed)) {
+      wakeOne();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(injectionMutex);
+      injection.push_back(boxed);
+    }
+    wakeOne();
+  }
+
+  // Submit a whole batch under one lock - the poller hands over an
+  // iteration's worth of callbacks in a single operation
+  void submitBulk(std::vector<Task> tasks) {
+    if (!running.load() || tasks.empty()) {
+      return;
+    }
+
+    pending.fetch_add(tasks.size(), std::memory_order_relaxed);
     {
-      std::lock_guard<std::mutex> lock(queueMutex);
-      taskQueue.push(std::move(task));
+      std::lock_guard<std::mutex> lock(injectionMutex);
+      for (Task &task : tasks) {
+        injection.push_back(new Task(std::move(task)));
+      }
+    }
+
+    if (sleepers.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      condition.notify_all();
     }
-    condition.notify_one();
   }
 
   // Get the number of pending tasks
   size_t getPendingTaskCount() const {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return taskQueue.size();
+    return pending.load(std::memory_order_relaxed);
   }
 
   // Check if executor is running
   bool isRunning() const { return running.load(); }
 
 private:
-  // Worker thread main loop
-  void workerLoop() {
-    while (running.load()) {
-      Task task;
+  void wakeOne() {
+    if (sleepers.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      condition.notify_one();
+    }
+  }
 
-      {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        condition.wait(
-            lock, [this] { return !taskQueue.empty() || !running.load(); });
+  // Pull one task from the injection queue and top the local ring up with
+  // a few more while the lock is held
+  Task *takeInjected(WorkerQueue &local) {
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    if (injection.empty()) {
+      return nullptr;
+    }
+    Task *task = injection.front();
+    injection.pop_front();
 
-        if (!running.load()) {
-          break;
-        }
+    size_t refill = 32;
+    while (refill-- > 0 && !injection.empty()) {
+      if (!local.push(injection.front())) {
+        break;
+      }
+      injection.pop_front();
+    }
+    return task;
+  }
+
+  Task *stealFromOthers(size_t self) {
+    for (size_t i = 1; i < numThreads; ++i) {
+      Task *task = queues[(self + i) % numThreads]->steal();
+      if (task) {
+        return task;
+      }
+    }
+    return nullptr;
+  }
 
-        if (!taskQueue.empty()) {
-          task = std::move(taskQueue.front());
-          taskQueue.pop();
-        } else {
-          continue;
+  // Worker thread main loop
+  void workerLoop(size_t index) {
+    currentExecutor() = this;
+    currentWorkerIndex() = index;
+    WorkerQueue &local = *queues[index];
+
+    while (running.load()) {
+      Task *task = local.pop();
+      if (!task) {
+        task = takeInjected(local);
+      }
+      if (!task) {
+        task = stealFromOthers(index);
+      }
+
+      if (task) {
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        try {
+          if (*task) {
+            (*task)();
+          }
+        } catch (...) {
+          // Swallow exceptions to prevent worker thread from crashing
+          // In production, you might want to log this
         }
+        delete task;
+        continue;
       }
 
-      // Execute the task outside the lock
-      try {
-        if (task) {
-          task();
+      // Everything was empty: park until a submitter notifies. The pending
+      // re-check under the lock closes the race with a submit that ran
+      // between our last scan and the wait.
+      sleepers.fetch_add(1, std::memory_order_acq_rel);
+      {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (pending.load(std::memory_order_relaxed) == 0 && running.load()) {
+          condition.wait_for(lock, std::chrono::milliseconds(50));
         }
-      } catch (...) {
-        // Swallow exceptions to prevent worker thread from crashing
-        // In production, you might want to log this
       }
+      sleepers.fetch_sub(1, std::memory_order_acq_rel);
     }
+
+    currentExecutor() = nullptr;
   }
-};
\ No newline at end of file
+};
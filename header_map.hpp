@@ -0,0 +1,110 @@
+#pragma once
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Flat storage for HTTP headers. Requests carry a dozen-odd headers, so an
+// inline array with linear scans beats a node-based map: no per-header node
+// allocation on the hot parse path, and name matching is case-insensitive
+// as RFC 7230 requires (std::map's operator< gave us neither). Entries past
+// INLINE_CAPACITY spill to a heap vector; clear() keeps the inline strings'
+// capacity, so a keep-alive connection's parser reuses the same storage
+// request after request.
+struct HeaderMap {
+  struct Header {
+    std::string name;
+    std::string value;
+  };
+
+  static constexpr size_t INLINE_CAPACITY = 16;
+
+  Header inline_entries[INLINE_CAPACITY];
+  size_t count = 0; // total entries, inline and spilled
+  std::vector<Header> spill;
+
+  static bool equalsIgnoreCase(const std::string &a, const std::string &b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (tolower(static_cast<unsigned char>(a[i])) !=
+          tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  Header &entryAt(size_t i) {
+    return i < INLINE_CAPACITY ? inline_entries[i] : spill[i - INLINE_CAPACITY];
+  }
+  const Header &entryAt(size_t i) const {
+    return i < INLINE_CAPACITY ? inline_entries[i] : spill[i - INLINE_CAPACITY];
+  }
+
+  // Value of the named header, or nullptr when absent
+  const std::string *find(const std::string &name) const {
+    for (size_t i = 0; i < count; ++i) {
+      const Header &header = entryAt(i);
+      if (equalsIgnoreCase(header.name, name)) {
+        return &header.value;
+      }
+    }
+    return nullptr;
+  }
+
+  bool contains(const std::string &name) const { return find(name) != nullptr; }
+
+  // Find-or-append, map-style: headers["Content-Type"] = "text/html"
+  std::string &operator[](const std::string &name) {
+    for (size_t i = 0; i < count; ++i) {
+      Header &header = entryAt(i);
+      if (equalsIgnoreCase(header.name, name)) {
+        return header.value;
+      }
+    }
+    if (count >= INLINE_CAPACITY) {
+      spill.emplace_back();
+    }
+    Header &slot = entryAt(count);
+    count++;
+    slot.name = name;
+    slot.value.clear();
+    return slot.value;
+  }
+
+  void clear() {
+    size_t inline_used = count < INLINE_CAPACITY ? count : INLINE_CAPACITY;
+    for (size_t i = 0; i < inline_used; ++i) {
+      inline_entries[i].name.clear();
+      inline_entries[i].value.clear();
+    }
+    spill.clear();
+    count = 0;
+  }
+
+  struct const_iterator {
+    const HeaderMap *map;
+    size_t index;
+
+    const Header &operator*() const { return map->entryAt(index); }
+    const Header *operator->() const { return &map->entryAt(index); }
+    const_iterator &operator++() {
+      ++index;
+      return *this;
+    }
+    bool operator==(const const_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return index != other.index;
+    }
+  };
+
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, count}; }
+};
@@ -0,0 +1,285 @@
+// Closed-loop HTTP load generator and latency benchmark.
+//
+// Opens a configurable number of concurrent connections, keeps exactly one
+// request in flight per connection (closed loop: the next request is issued
+// the moment the previous response completes), and reports requests/sec plus
+// p50/p90/p99/p999 latency from a fixed-bucket histogram. A warmup phase runs
+// before the measured window so connection setup and server cold paths don't
+// skew the numbers.
+//
+//   http_bench [-c connections] [-d seconds] [-w warmup_seconds]
+//              [-k on|off] [-p post_body] URL [URL...]
+//
+// Several URLs form the request mix (round-robin); prefix one with "POST:"
+// to send it as a POST with the -p body. All URLs must share one host:port -
+// each connection is reused across the whole mix.
+
+#include "bench_histogram.hpp"
+#include "http_client.hpp"
+#include "poller.hpp"
+#include "steady_clock.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchTarget {
+  HttpMethod method = HttpMethod::GET;
+  std::string url = "";
+  std::string body = "";
+};
+
+struct BenchConfig {
+  size_t connections = 50;
+  int duration_s = 10;
+  int warmup_s = 2;
+  bool keep_alive = true;
+  std::string post_body = "";
+  std::vector<BenchTarget> targets = {};
+};
+
+struct BenchConn {
+  Socket *socket = nullptr;
+  HttpClient *client = nullptr;
+  SteadyClock::TimePoint sent_at = {};
+  bool in_flight = false;
+};
+
+struct BenchRunner {
+  Poller &poller;
+  BenchConfig cfg;
+
+  std::vector<BenchConn> conns = {};
+  BenchHistogram hist = {};
+  uint64_t completed = 0;
+  uint64_t errors = 0;
+  size_t next_target = 0;
+  bool measuring = false;
+  bool running = true;
+  SteadyClock::TimePoint measure_start = {};
+
+  BenchRunner(Poller &poller, BenchConfig cfg)
+      : poller(poller), cfg(std::move(cfg)) {}
+
+  void start() {
+    conns.resize(cfg.connections);
+    for (size_t i = 0; i < cfg.connections; i++) {
+      openConnection(i);
+      sendNext(i);
+    }
+
+    poller.setTimeout(cfg.warmup_s * 1000, [this]() {
+      hist.reset();
+      completed = 0;
+      errors = 0;
+      measuring = true;
+      measure_start = SteadyClock::now();
+      fprintf(stderr, "warmup done, measuring for %ds...\n", cfg.duration_s);
+    });
+    poller.setTimeout((cfg.warmup_s + cfg.duration_s) * 1000, [this]() {
+      measuring = false;
+      running = false;
+      report();
+      poller.stop();
+    });
+  }
+
+  void openConnection(size_t i) {
+    BenchConn &conn = conns[i];
+    conn.socket = poller.createSocket();
+    conn.client = HttpClient::fromSocket(conn.socket);
+    conn.client->keep_alive = cfg.keep_alive;
+    conn.in_flight = false;
+
+    conn.socket->onClose = [this, i](Socket &) {
+      if (!running) {
+        return;
+      }
+      BenchConn &closed = conns[i];
+      if (closed.in_flight) {
+        // Closed mid-request (idle reap or error) - the request is lost
+        closed.in_flight = false;
+        if (measuring) {
+          errors++;
+        }
+      }
+      openConnection(i);
+      sendNext(i);
+    };
+
+    conn.socket->onConnect = [this, i](Socket &sock, bool ok) {
+      if (ok || !running) {
+        return; // buffered request bytes flush on their own
+      }
+      if (measuring) {
+        errors++;
+      }
+      if (sock.file_descriptor >= 0) {
+        sock.stop(); // onClose reconnects
+        return;
+      }
+      // Failed before a fd existed: back off briefly so a down server
+      // doesn't turn into a reconnect spin
+      poller.setTimeout(100, [this, i]() {
+        if (running) {
+          openConnection(i);
+          sendNext(i);
+        }
+      });
+    };
+
+    const BenchTarget &first = cfg.targets[0];
+    conn.client->parseUrl(first.url);
+    conn.socket->connectAsync(conn.client->request.host,
+                              conn.client->request.port);
+  }
+
+  void sendNext(size_t i) {
+    BenchConn &conn = conns[i];
+    const BenchTarget &target = cfg.targets[next_target++ % cfg.targets.size()];
+
+    HttpClient *client = conn.client;
+    client->request = HttpRequest{};
+    client->request.method = target.method;
+    client->request.url = target.url;
+    client->request.body = target.body;
+    client->response = HttpResponse{};
+    client->response.status = HttpStatus::PENDING;
+    client->rx_buffer.clear();
+    client->parseUrl(target.url);
+    client->onResponse = [](HttpResponse &) {};
+    client->onComplete = [this, i](HttpClient &done, bool reusable) {
+      requestDone(i, done, reusable);
+    };
+
+    conn.sent_at = SteadyClock::now();
+    conn.in_flight = true;
+    conn.socket->write(client->buildRequest());
+  }
+
+  void requestDone(size_t i, HttpClient &client, bool reusable) {
+    BenchConn &conn = conns[i];
+    conn.in_flight = false;
+
+    if (measuring) {
+      uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        SteadyClock::now() - conn.sent_at)
+                        .count();
+      hist.record(us);
+      completed++;
+      if (client.response.status_code >= 400) {
+        errors++;
+      }
+    }
+    if (!running) {
+      return;
+    }
+
+    if (cfg.keep_alive && reusable) {
+      sendNext(i); // same connection, next request in the mix
+    } else {
+      conn.socket->stop(); // onClose opens a fresh connection
+    }
+  }
+
+  void report() const {
+    double elapsed_s = std::chrono::duration_cast<std::chrono::microseconds>(
+                           SteadyClock::now() - measure_start)
+                           .count() /
+                       1e6;
+    double rps = elapsed_s > 0 ? completed / elapsed_s : 0;
+    double mean_ms = hist.count ? hist.sum_us / 1e3 / hist.count : 0;
+
+    printf("\n");
+    printf("connections:  %zu (keep-alive %s)\n", cfg.connections,
+           cfg.keep_alive ? "on" : "off");
+    printf("duration:     %.2fs measured (+%ds warmup)\n", elapsed_s,
+           cfg.warmup_s);
+    printf("requests:     %llu (%llu errors)\n",
+           static_cast<unsigned long long>(completed),
+           static_cast<unsigned long long>(errors));
+    printf("throughput:   %.0f req/s\n", rps);
+    printf("latency mean: %.3f ms\n", mean_ms);
+    printf("latency p50:  %.3f ms\n", hist.percentileUs(0.50) / 1e3);
+    printf("latency p90:  %.3f ms\n", hist.percentileUs(0.90) / 1e3);
+    printf("latency p99:  %.3f ms\n", hist.percentileUs(0.99) / 1e3);
+    printf("latency p999: %.3f ms\n", hist.percentileUs(0.999) / 1e3);
+    printf("latency max:  %.3f ms\n", hist.max_us / 1e3);
+  }
+};
+
+void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-c connections] [-d seconds] [-w warmup_seconds]\n"
+          "       [-k on|off] [-p post_body] URL [URL...]\n"
+          "Prefix a URL with POST: to send it as a POST with the -p body.\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  BenchConfig cfg;
+
+  int arg = 1;
+  for (; arg < argc; arg++) {
+    if (strcmp(argv[arg], "-c") == 0 && arg + 1 < argc) {
+      cfg.connections = std::strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "-d") == 0 && arg + 1 < argc) {
+      cfg.duration_s = std::atoi(argv[++arg]);
+    } else if (strcmp(argv[arg], "-w") == 0 && arg + 1 < argc) {
+      cfg.warmup_s = std::atoi(argv[++arg]);
+    } else if (strcmp(argv[arg], "-k") == 0 && arg + 1 < argc) {
+      cfg.keep_alive = strcmp(argv[++arg], "off") != 0;
+    } else if (strcmp(argv[arg], "-p") == 0 && arg + 1 < argc) {
+      cfg.post_body = argv[++arg];
+    } else if (argv[arg][0] == '-') {
+      usage(argv[0]);
+      return 1;
+    } else {
+      break; // positional URLs from here
+    }
+  }
+
+  for (; arg < argc; arg++) {
+    BenchTarget target;
+    const char *url = argv[arg];
+    if (strncmp(url, "POST:", 5) == 0) {
+      target.method = HttpMethod::POST;
+      target.body = cfg.post_body;
+      url += 5;
+    }
+    target.url = url;
+    cfg.targets.push_back(target);
+  }
+
+  if (cfg.targets.empty() || cfg.connections == 0 || cfg.duration_s <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // Each connection carries the whole mix, so the mix must share a target
+  std::string host;
+  uint16_t port = 0;
+  std::string path;
+  HttpClient::splitUrl(cfg.targets[0].url, host, port, path);
+  for (const BenchTarget &target : cfg.targets) {
+    std::string h;
+    uint16_t p = 0;
+    HttpClient::splitUrl(target.url, h, p, path);
+    if (h != host || p != port) {
+      fprintf(stderr, "All URLs must share one host:port (%s:%u vs %s:%u)\n",
+              host.c_str(), port, h.c_str(), p);
+      return 1;
+    }
+  }
+
+  Poller poller;
+  BenchRunner runner(poller, std::move(cfg));
+  runner.start();
+  poller.start(); // blocks until the report timer stops the loop
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include "poller.hpp"
 #include "socket.hpp"
 #include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <sstream>
 
@@ -14,8 +15,6 @@ HttpClient *HttpClient::fromSocket(Socket *socket) {
     client->socket = socket;
 
     socket->onData = [client](Socket &socket, const BufferView &data) {
-      std::cout << "HttpClient received data: " << data.size << " bytes"
-                << std::endl;
       client->handleSocketData(data);
     };
 
@@ -26,12 +25,10 @@ HttpClient *HttpClient::fromSocket(Socket *socket) {
 }
 
 bool HttpClient::get(const std::string &url, ResponseCallback callback) {
-  std::cout << "Get 1 request" << std::endl;
   request.method = HttpMethod::GET;
   request.url = url;
   request.body = "";
   onResponse = callback;
-  std::cout << "Get request" << std::endl;
   return sendRequest(request, callback);
 }
 
@@ -65,6 +62,7 @@ bool HttpClient::sendRequest(HttpRequest &req, ResponseCallback callback) {
   // Reset response
   response = HttpResponse{};
   response.status = HttpStatus::PENDING;
+  rx_buffer.clear();
 
   // Parse URL
   parseUrl(req.url);
@@ -87,15 +85,20 @@ bool HttpClient::sendRequest(HttpRequest &req, ResponseCallback callback) {
 }
 
 void HttpClient::parseUrl(const std::string &url) {
-  request.host = "";
-  request.port = 80;
-  request.path = "/";
+  splitUrl(url, request.host, request.port, request.path);
+}
+
+void HttpClient::splitUrl(const std::string &url, std::string &host,
+                          uint16_t &port, std::string &path) {
+  host = "";
+  port = 80;
+  path = "/";
 
   size_t protocol_end = url.find("://");
   if (protocol_end != std::string::npos) {
     std::string protocol = url.substr(0, protocol_end);
     if (protocol == "https") {
-      request.port = 443;
+      port = 443;
     }
   }
 
@@ -105,18 +108,18 @@ void HttpClient::parseUrl(const std::string &url) {
 
   if (port_pos != std::string::npos &&
       (host_end == std::string::npos || port_pos < host_end)) {
-    request.host = url.substr(host_start, port_pos - host_start);
+    host = url.substr(host_start, port_pos - host_start);
     size_t port_start = port_pos + 1;
     size_t port_end = host_end != std::string::npos ? host_end : url.length();
-    request.port = std::stoi(url.substr(port_start, port_end - port_start));
+    port = std::stoi(url.substr(port_start, port_end - port_start));
   } else {
-    request.host = url.substr(host_start, host_end != std::string::npos
-                                              ? host_end - host_start
-                                              : url.length() - host_start);
+    host = url.substr(host_start, host_end != std::string::npos
+                                      ? host_end - host_start
+                                      : url.length() - host_start);
   }
 
   if (host_end != std::string::npos) {
-    request.path = url.substr(host_end);
+    path = url.substr(host_end);
   }
 }
 
@@ -150,11 +153,11 @@ std::string HttpClient::buildRequest() {
 
   // Headers
   ss << "Host: " << request.host << ":" << request.port << "\r\n";
-  ss << "Connection: close\r\n";
+  ss << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
 
   // Add custom headers
   for (const auto &header : request.headers) {
-    ss << header.first << ": " << header.second << "\r\n";
+    ss << header.name << ": " << header.value << "\r\n";
   }
 
   // Add content length for POST/PUT
@@ -175,17 +178,15 @@ std::string HttpClient::buildRequest() {
 }
 
 void HttpClient::parseResponse(const std::string &data) {
-  static std::string buffer = "";
-  buffer += data;
+  rx_buffer += data;
 
   // Check if we have complete headers
-  size_t header_end = buffer.find("\r\n\r\n");
+  size_t header_end = rx_buffer.find("\r\n\r\n");
   if (header_end == std::string::npos) {
     return; // Incomplete headers
   }
 
-  std::string headers_str = buffer.substr(0, header_end);
-  std::string body_str = buffer.substr(header_end + 4);
+  std::string headers_str = rx_buffer.substr(0, header_end);
 
   // Parse status line
   size_t first_line_end = headers_str.find('\n');
@@ -195,8 +196,14 @@ void HttpClient::parseResponse(const std::string &data) {
     size_t space2 = status_line.find(' ', space1 + 1);
 
     if (space1 != std::string::npos && space2 != std::string::npos) {
-      response.status_code =
-          std::stoi(status_line.substr(space1 + 1, space2 - space1 - 1));
+      // Server-sent token: parse without exceptions (stoi throws on junk)
+      const char *begin = status_line.data() + space1 + 1;
+      const char *end = status_line.data() + space2;
+      auto [ptr, ec] = std::from_chars(begin, end, response.status_code);
+      if (ec != std::errc() || ptr != end) {
+        failResponse("invalid status code in response");
+        return;
+      }
       response.status_text = status_line.substr(space2 + 1);
     }
   }
@@ -225,20 +232,310 @@ void HttpClient::parseResponse(const std::string &data) {
     }
   }
 
-  // Set body
-  response.body = body_str;
+  // Framing: a Content-Length response completes once the body is full and
+  // leaves the connection reusable. Without one, a Connection: close
+  // request completes with whatever arrived (close-delimited), while a
+  // keep-alive request waits for the close (handleClose finishes it).
+  size_t body_start = header_end + 4;
+  const std::string *length = response.headers.find("Content-Length");
+  if (length) {
+    // Server-sent and possibly hostile: parse without exceptions (stoul
+    // throws on junk or overflow) and fail the request like any other
+    // malformed response instead of unwinding off the poller thread
+    size_t need = 0;
+    const char *begin = length->data();
+    const char *end = begin + length->size();
+    auto [ptr, ec] = std::from_chars(begin, end, need);
+    if (ec != std::errc() || ptr != end) {
+      failResponse("invalid Content-Length in response");
+      return;
+    }
+    if (rx_buffer.size() - body_start < need) {
+      return; // Incomplete body
+    }
+    response.body = rx_buffer.substr(body_start, need);
+    finishResponse(true);
+  } else if (!keep_alive) {
+    response.body = rx_buffer.substr(body_start);
+    finishResponse(false);
+  }
+}
+
+void HttpClient::failResponse(const std::string &why) {
+  response.status = HttpStatus::ERROR;
+  response.error_message = why;
+  rx_buffer.clear();
+  if (onResponse) {
+    onResponse(response);
+  }
+  if (onComplete) {
+    onComplete(*this, false); // framing is unusable; drop the connection
+  }
+}
+
+void HttpClient::finishResponse(bool reusable) {
+  // A server that answered Connection: close won't take another request
+  const std::string *connection = response.headers.find("Connection");
+  if (connection && *connection == "close") {
+    reusable = false;
+  }
+
   response.status = HttpStatus::COMPLETED;
+  rx_buffer.clear();
 
-  // Call callback
   if (onResponse) {
     onResponse(response);
   }
+  if (onComplete) {
+    onComplete(*this, reusable);
+  }
+}
 
-  // Clear buffer for next request
-  buffer.clear();
+void HttpClient::handleClose() {
+  if (response.status != HttpStatus::PENDING) {
+    return;
+  }
+  size_t header_end = rx_buffer.find("\r\n\r\n");
+  if (header_end == std::string::npos) {
+    return; // Nothing usable arrived - the owner decides retry or error
+  }
+  response.body = rx_buffer.substr(header_end + 4);
+  finishResponse(false);
 }
 
 void HttpClient::handleSocketData(const BufferView &data) {
   std::string data_str(data.data, data.size);
   parseResponse(data_str);
-}
\ No newline at end of file
+}
+
+// ---------------------------------------------------------------------------
+// HttpClientPool
+
+HttpClientPool::HttpClientPool(Poller *poller, size_t max_per_host)
+    : poller(poller), max_per_host(max_per_host) {}
+
+bool HttpClientPool::get(const std::string &url,
+                         HttpClient::ResponseCallback callback) {
+  return request(HttpMethod::GET, url, "", callback);
+}
+
+bool HttpClientPool::post(const std::string &url, const std::string &body,
+                          HttpClient::ResponseCallback callback) {
+  return request(HttpMethod::POST, url, body, callback);
+}
+
+bool HttpClientPool::put(const std::string &url, const std::string &body,
+                         HttpClient::ResponseCallback callback) {
+  return request(HttpMethod::PUT, url, body, callback);
+}
+
+bool HttpClientPool::delete_(const std::string &url,
+                             HttpClient::ResponseCallback callback) {
+  return request(HttpMethod::DELETE, url, "", callback);
+}
+
+bool HttpClientPool::request(HttpMethod method, const std::string &url,
+                             const std::string &body,
+                             HttpClient::ResponseCallback callback) {
+  HttpRequest req;
+  req.method = method;
+  req.url = url;
+  req.body = body;
+  return send(req, callback);
+}
+
+bool HttpClientPool::send(const HttpRequest &req,
+                          HttpClient::ResponseCallback callback) {
+  std::string host, path;
+  uint16_t port = 80;
+  HttpClient::splitUrl(req.url, host, port, path);
+  if (host.empty() || !poller) {
+    return false;
+  }
+
+  std::string key = host + ":" + std::to_string(port);
+  HostEntry &entry = hosts[key];
+
+  // Reuse the most recently parked connection - it is the least likely to
+  // have hit the server's idle timeout
+  while (!entry.idle.empty()) {
+    Socket *socket = entry.idle.back();
+    entry.idle.pop_back();
+    if (socket->file_descriptor >= 0) {
+      dispatch(key, socket, true, PendingRequest{req, callback});
+      return true;
+    }
+  }
+
+  if (entry.in_flight >= max_per_host) {
+    // At the cap with nothing idle: queue until a connection frees up
+    entry.pending.push_back(PendingRequest{req, callback});
+    return true;
+  }
+
+  dispatch(key, poller->createSocket(), false, PendingRequest{req, callback});
+  return true;
+}
+
+void HttpClientPool::dispatch(const std::string &key, Socket *socket,
+                              bool reused, PendingRequest req) {
+  hosts[key].in_flight++;
+
+  HttpClient *client = HttpClient::fromSocket(socket);
+  client->keep_alive = true;
+  client->rx_buffer.clear();
+  client->response = HttpResponse{};
+  client->response.status = HttpStatus::PENDING;
+  client->request = req.req; // method, url, body, and custom headers
+  client->onResponse = req.callback;
+  client->parseUrl(req.req.url);
+
+  client->onComplete = [this, key](HttpClient &done, bool reusable) {
+    release(key, done.socket, reusable);
+  };
+
+  // Mid-flight close: a reused connection that died before delivering any
+  // bytes raced the server's idle shutdown - retry it once on a fresh
+  // connection. Anything else completes close-delimited or errors out.
+  // (The request rides behind a shared_ptr to keep the capture inside the
+  // callback's inline storage.)
+  auto retry = std::make_shared<PendingRequest>(std::move(req));
+  socket->onClose = [this, key, reused, retry](Socket &closed) {
+    HttpClient *client = closed.userData.toA<HttpClient>();
+    hosts[key].in_flight--;
+    if (client->response.status == HttpStatus::PENDING) {
+      client->onComplete = nullptr; // the close path owns the bookkeeping
+      if (reused && client->rx_buffer.empty()) {
+        send(retry->req, retry->callback);
+      } else {
+        client->handleClose();
+        if (client->response.status == HttpStatus::PENDING) {
+          client->response.status = HttpStatus::ERROR;
+          client->response.error_message = "connection closed before response";
+          if (client->onResponse) {
+            client->onResponse(client->response);
+          }
+        }
+      }
+    }
+    drainPending(key);
+  };
+
+  if (!reused && socket->file_descriptor < 0) {
+    socket->onConnect = [this, key](Socket &sock, bool ok) {
+      if (ok) {
+        return; // the request bytes below were buffered and already flushed
+      }
+      if (sock.file_descriptor >= 0) {
+        sock.stop(); // onClose runs the error path
+        return;
+      }
+      // Resolution or connect failed before a fd existed; fail here
+      HttpClient *client = sock.userData.toA<HttpClient>();
+      hosts[key].in_flight--;
+      client->response.status = HttpStatus::ERROR;
+      client->response.error_message =
+          "Failed to connect to " + client->request.host + ":" +
+          std::to_string(client->request.port);
+      if (client->onResponse) {
+        client->onResponse(client->response);
+      }
+      drainPending(key);
+    };
+    socket->connectAsync(client->request.host, client->request.port);
+  }
+
+  socket->write(client->buildRequest());
+}
+
+void HttpClientPool::release(const std::string &key, Socket *socket,
+                             bool reusable) {
+  HostEntry &entry = hosts[key];
+  entry.in_flight--;
+
+  if (reusable && socket->file_descriptor >= 0 &&
+      entry.idle.size() < max_per_host) {
+    // Park it; if the server closes it while idle, drop it from the list
+    // so it is never handed to a request
+    socket->onClose = [this, key](Socket &closed) {
+      HostEntry &entry = hosts[key];
+      auto it = std::find(entry.idle.begin(), entry.idle.end(), &closed);
+      if (it != entry.idle.end()) {
+        entry.idle.erase(it);
+      }
+    };
+    entry.idle.push_back(socket);
+  } else {
+    socket->onClose = [](Socket &) {};
+    socket->stop();
+  }
+
+  drainPending(key);
+}
+
+void HttpClientPool::drainPending(const std::string &key) {
+  HostEntry &entry = hosts[key];
+  if (entry.pending.empty()) {
+    return;
+  }
+  if (entry.idle.empty() && entry.in_flight >= max_per_host) {
+    return;
+  }
+  PendingRequest req = std::move(entry.pending.front());
+  entry.pending.pop_front();
+  send(req.req, req.callback);
+}
+
+void HttpClientPool::fetchAll(std::vector<HttpRequest> requests,
+                              BatchCallback on_response,
+                              BatchDoneCallback on_done) {
+  auto state = std::make_shared<BatchState>();
+  state->requests = std::move(requests);
+  state->on_response = on_response;
+  state->on_done = on_done;
+
+  if (state->requests.empty()) {
+    if (on_done) {
+      on_done();
+    }
+    return;
+  }
+  pumpBatch(state);
+}
+
+void HttpClientPool::pumpBatch(std::shared_ptr<BatchState> state) {
+  // Keep the window full: launch until the concurrency limit (the per-host
+  // cap still queues beneath it) and refill as each response lands
+  while (state->next < state->requests.size() &&
+         state->outstanding < max_batch_concurrency) {
+    size_t index = state->next++;
+    state->outstanding++;
+
+    bool ok = send(state->requests[index],
+                   [this, state, index](HttpResponse &response) {
+                     state->outstanding--;
+                     if (state->on_response) {
+                       state->on_response(index, response);
+                     }
+                     pumpBatch(state);
+                   });
+    if (!ok) {
+      // Unparseable URL: report it like a failed response and move on
+      state->outstanding--;
+      HttpResponse error;
+      error.status = HttpStatus::ERROR;
+      error.error_message =
+          "invalid request URL: " + state->requests[index].url;
+      if (state->on_response) {
+        state->on_response(index, error);
+      }
+    }
+  }
+
+  if (state->outstanding == 0 && state->next >= state->requests.size() &&
+      state->on_done) {
+    BatchDoneCallback done = state->on_done;
+    state->on_done = nullptr; // fire exactly once
+    done();
+  }
+}
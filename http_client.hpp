@@ -1,32 +1,15 @@
 #pragma once
 
+#include "http_message.hpp"
 #include "socket.hpp"
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
-enum class HttpMethod { GET, POST, PUT, DELETE, HEAD, OPTIONS };
-
-enum class HttpStatus { PENDING, COMPLETED, ERROR };
-
-struct HttpRequest {
-  HttpMethod method = HttpMethod::GET;
-  std::string url = "";
-  std::string host = "";
-  uint16_t port = 80;
-  std::string path = "/";
-  std::map<std::string, std::string> headers = {};
-  std::string body = "";
-};
-
-struct HttpResponse {
-  int status_code = 0;
-  std::string status_text = "";
-  std::map<std::string, std::string> headers = {};
-  std::string body = "";
-  HttpStatus status = HttpStatus::PENDING;
-  std::string error_message = "";
-};
+struct Poller;
 
 struct HttpClient {
   Socket *socket = nullptr;
@@ -36,6 +19,21 @@ struct HttpClient {
   using ResponseCallback = std::function<void(HttpResponse &)>;
   ResponseCallback onResponse = [](HttpResponse &) {};
 
+  // Set by HttpClientPool: fires once the response is fully framed (or the
+  // connection closed), with whether the connection can carry another
+  // request afterwards
+  using CompleteCallback = std::function<void(HttpClient &, bool reusable)>;
+  CompleteCallback onComplete;
+
+  // Ask for keep-alive instead of Connection: close (pooled requests).
+  // Keep-alive responses are framed by Content-Length; without one the
+  // response completes when the server closes the connection.
+  bool keep_alive = false;
+
+  // Bytes of the in-flight response (per client - this was a static shared
+  // by every client instance)
+  std::string rx_buffer = "";
+
   // Constructor
   static HttpClient *fromSocket(Socket *socket);
 
@@ -50,7 +48,85 @@ struct HttpClient {
   // Internal methods
   bool sendRequest(HttpRequest &req, ResponseCallback callback);
   void parseUrl(const std::string &url);
+  static void splitUrl(const std::string &url, std::string &host,
+                       uint16_t &port, std::string &path);
   std::string buildRequest();
   void parseResponse(const std::string &data);
   void handleSocketData(const BufferView &data);
-};
\ No newline at end of file
+  // Complete the current response and notify the owner
+  void finishResponse(bool reusable);
+  // Fail the current response on unusable server output (bad status line,
+  // bad Content-Length); the connection's framing can't be trusted, so it
+  // is never reused
+  void failResponse(const std::string &why);
+  // The connection closed mid-response: complete a close-delimited body if
+  // the headers already arrived, otherwise leave the response PENDING for
+  // the owner to retry or fail
+  void handleClose();
+};
+
+// Keep-alive connection pool for clients that hit the same hosts
+// repeatedly (crawlers, API fan-out). Finished connections park in a
+// per-host:port idle list and the next request to that host reuses the
+// most recently parked one instead of opening a new TCP connection; fresh
+// connections go through the non-blocking connectAsync path. At most
+// max_per_host connections exist per host - requests beyond the cap queue
+// and dispatch as connections free up. A pooled connection the server
+// closed while it idled is retried once on a fresh connection.
+struct HttpClientPool {
+  Poller *poller = nullptr;
+  size_t max_per_host = 6;
+
+  struct PendingRequest {
+    HttpRequest req = {};
+    HttpClient::ResponseCallback callback = nullptr;
+  };
+
+  struct HostEntry {
+    std::vector<Socket *> idle = {};
+    size_t in_flight = 0;
+    std::deque<PendingRequest> pending = {};
+  };
+  std::map<std::string, HostEntry> hosts = {};
+
+  HttpClientPool(Poller *poller, size_t max_per_host = 6);
+
+  // Same callback signatures as HttpClient
+  bool get(const std::string &url, HttpClient::ResponseCallback callback);
+  bool post(const std::string &url, const std::string &body,
+            HttpClient::ResponseCallback callback);
+  bool put(const std::string &url, const std::string &body,
+           HttpClient::ResponseCallback callback);
+  bool delete_(const std::string &url, HttpClient::ResponseCallback callback);
+
+  // Issue a fully-specified request (custom headers included) through the
+  // pool; the convenience methods above wrap this
+  bool send(const HttpRequest &req, HttpClient::ResponseCallback callback);
+
+  // Bulk fetch: fan the whole batch across pooled connections, keeping at
+  // most max_batch_concurrency requests in flight (the per-host cap still
+  // applies underneath). on_response fires per request with its index in
+  // the batch, in completion order; on_done fires once all have completed.
+  using BatchCallback = std::function<void(size_t index, HttpResponse &)>;
+  using BatchDoneCallback = std::function<void()>;
+  size_t max_batch_concurrency = 32;
+  void fetchAll(std::vector<HttpRequest> requests, BatchCallback on_response,
+                BatchDoneCallback on_done = nullptr);
+
+  // Internal methods
+  bool request(HttpMethod method, const std::string &url,
+               const std::string &body, HttpClient::ResponseCallback callback);
+  void dispatch(const std::string &key, Socket *socket, bool reused,
+                PendingRequest req);
+  void release(const std::string &key, Socket *socket, bool reusable);
+  void drainPending(const std::string &key);
+
+  struct BatchState {
+    std::vector<HttpRequest> requests = {};
+    BatchCallback on_response = nullptr;
+    BatchDoneCallback on_done = nullptr;
+    size_t next = 0;
+    size_t outstanding = 0;
+  };
+  void pumpBatch(std::shared_ptr<BatchState> state);
+};
@@ -25,7 +25,7 @@ int main() {
                   << response.status_text << std::endl;
         std::cout << "Headers:" << std::endl;
         for (const auto &header : response.headers) {
-          std::cout << "  " << header.first << ": " << header.second
+          std::cout << "  " << header.name << ": " << header.value
                     << std::endl;
         }
         std::cout << "Body:" << std::endl;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "header_map.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Shared HTTP message types used by both HttpClient and HttpServer. These
+// used to be defined separately (and incompatibly) in http_client.hpp and
+// http_server.hpp - two different structs named HttpRequest linked into the
+// same binary is an ODR violation that corrupted memory whenever both
+// translation units were present. One definition carries the superset of
+// fields: host/port for outgoing client requests, query/remote_* for
+// incoming server requests.
+
+enum class HttpMethod { GET, POST, PUT, DELETE, HEAD, OPTIONS };
+
+enum class HttpStatus { PENDING, COMPLETED, ERROR };
+
+struct HttpRequest {
+  HttpMethod method = HttpMethod::GET;
+  std::string url = "";
+
+  // Client side: where the request is going
+  std::string host = "";
+  uint16_t port = 80;
+
+  std::string path = "/";
+  std::string query = "";
+  std::string version = "HTTP/1.1";
+  HeaderMap headers = {};
+  // Captured ":name" route segments, e.g. /users/:id -> params["id"]
+  std::map<std::string, std::string> params = {};
+  std::string body = "";
+
+  // Server side: who the request came from
+  std::string remote_addr = "";
+  uint16_t remote_port = 0;
+};
+
+struct HttpResponse {
+  int status_code = 200;
+  std::string status_text = "OK";
+  HeaderMap headers = {};
+  std::string body = "";
+  HttpStatus status = HttpStatus::PENDING;
+  std::string error_message = "";
+};
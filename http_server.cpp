@@ -1,14 +1,25 @@
 #include "http_server.hpp"
 #include "websocket_server.hpp"
 #include "poller.hpp"
+#if USE_AREA_ALLOCATORS
+#include "poller_memory.hpp"
+#endif
 #include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
 #include <iostream>
-#include <sstream>
+#include <sys/stat.h>
 
 HttpServer::HttpServer(Listener *listener) : listener(listener) {
   if (listener) {
-    listener->onAccept = [this](Socket *socket) {
-      this->handleConnection(*socket);
+    // Batched accept: one POLLIN wakeup drains the whole backlog, so a
+    // reconnect storm pays the dispatch overhead per batch, not per fd
+    listener->onAcceptMany = [this](std::span<Socket *const> sockets) {
+      for (Socket *socket : sockets) {
+        this->handleConnection(*socket);
+      }
     };
   }
 }
@@ -20,64 +31,491 @@ void HttpServer::enableWebSocketUpgrade(WebSocketServer *ws_server) {
 void HttpServer::get(
     const std::string &path,
     std::function<void(HttpRequest &, HttpResponse &)> handler) {
-  routes["GET:" + path] = handler;
+  router.add(HttpMethod::GET, path, handler);
 }
 
 void HttpServer::post(
     const std::string &path,
     std::function<void(HttpRequest &, HttpResponse &)> handler) {
-  routes["POST:" + path] = handler;
+  router.add(HttpMethod::POST, path, handler);
 }
 
 void HttpServer::put(
     const std::string &path,
     std::function<void(HttpRequest &, HttpResponse &)> handler) {
-  routes["PUT:" + path] = handler;
+  router.add(HttpMethod::PUT, path, handler);
 }
 
 void HttpServer::delete_(
     const std::string &path,
     std::function<void(HttpRequest &, HttpResponse &)> handler) {
-  routes["DELETE:" + path] = handler;
+  router.add(HttpMethod::DELETE, path, handler);
+}
+
+void HttpServer::streamBody(
+    HttpMethod method, const std::string &path,
+    std::function<void(HttpRequest &, std::shared_ptr<HttpBodyReader>)>
+        handler) {
+  body_routes.push_back(BodyRoute{method, path, std::move(handler)});
+}
+
+void HttpServer::beginBodyStream(Socket &socket, HttpRequestParser &parser) {
+  for (BodyRoute &route : body_routes) {
+    if (route.method != parser.request.method ||
+        route.path != parser.request.path) {
+      continue;
+    }
+    parser.request.remote_addr = socket.remote_addr;
+    parser.request.remote_port = socket.remote_port;
+
+    auto reader = std::make_shared<HttpBodyReader>();
+    reader->server = this;
+    reader->poller = socket.poller;
+    reader->socket_id = socket.id;
+    reader->keep_alive = shouldKeepAlive(parser.request);
+
+    // Install before the handler runs so the first body bytes of this very
+    // chunk already flow through the reader
+    parser.body_reader = reader;
+    route.handler(parser.request, reader);
+    return;
+  }
+}
+
+void HttpServer::finishBodyStream(Socket &socket, HttpRequestParser &parser) {
+  std::shared_ptr<HttpBodyReader> reader = parser.body_reader;
+  parser.body_reader = nullptr;
+
+  HttpResponse response;
+  if (reader->onBodyComplete) {
+    reader->onBodyComplete(parser.request, response);
+  }
+  if (!response.headers.contains("Connection")) {
+    response.headers["Connection"] =
+        reader->keep_alive ? "keep-alive" : "close";
+  }
+  writeResponse(socket, response);
+  if (!reader->keep_alive) {
+    socket.close_after_flush = true;
+  }
+}
+
+void HttpBodyReader::pause() {
+  if (poller) {
+    poller->pauseReads(socket_id);
+  }
+}
+
+void HttpBodyReader::resume() {
+  if (poller) {
+    poller->resumeReads(socket_id);
+  }
+}
+
+void HttpServer::enableMetrics(const std::string &path) {
+  get(path, [](HttpRequest &, HttpResponse &response) {
+    response.headers["Content-Type"] = "text/plain; version=0.0.4";
+    response.body = MetricsRegistry::instance().renderPrometheus();
+  });
+}
+
+bool HttpRequestParser::consume(BufferChain::Cursor &cursor) {
+  if (malformed) {
+    return false; // the connection is being closed; drop further bytes
+  }
+  while (cursor.remaining() > 0) {
+    if (state == State::BODY) {
+      if (body_reader) {
+        // Streaming mode: forward the body in bounded slices - the memory
+        // held per upload is this scratch buffer, not the Content-Length
+        char scratch[16 * 1024];
+        while (body_received < content_length && cursor.remaining() > 0) {
+          size_t take = std::min(
+              {content_length - body_received, cursor.remaining(),
+               sizeof(scratch)});
+          cursor.read(scratch, take);
+          body_received += take;
+          if (body_reader->onBodyChunk &&
+              !body_reader->onBodyChunk(BufferView(scratch, take))) {
+            body_reader->pause(); // backpressure: POLLIN off until resume()
+          }
+        }
+        if (body_received < content_length) {
+          return false;
+        }
+        state = State::COMPLETE;
+        return true;
+      }
+
+      // Take as much of the body as this chunk provides; the rest arrives
+      // on later callbacks and resumes right here
+      size_t needed = content_length - request.body.size();
+      size_t take = std::min(needed, cursor.remaining());
+      size_t old_size = request.body.size();
+      request.body.resize(old_size + take);
+      cursor.read(&request.body[old_size], take);
+      if (request.body.size() < content_length) {
+        return false; // chunk exhausted, body still incomplete
+      }
+      state = State::COMPLETE;
+      return true;
+    }
+
+    char byte = static_cast<char>(cursor.next());
+    if (byte != '\n') {
+      line_buffer.push_back(byte);
+      continue;
+    }
+    if (!line_buffer.empty() && line_buffer.back() == '\r') {
+      line_buffer.pop_back();
+    }
+
+    if (state == State::REQUEST_LINE) {
+      parseRequestLine(line_buffer);
+      state = State::HEADERS;
+    } else if (state == State::HEADERS) {
+      if (line_buffer.empty()) {
+        // Blank line ends the headers; the body length decides what's next.
+        // Content-Length is attacker-controlled: parse without exceptions
+        // and reject anything that isn't a plain in-range number - stoul
+        // would throw straight through the poller loop into terminate().
+        const std::string *length = request.headers.find("Content-Length");
+        content_length = 0;
+        if (length) {
+          const char *begin = length->data();
+          const char *end = begin + length->size();
+          auto [ptr, ec] = std::from_chars(begin, end, content_length);
+          if (ec != std::errc() || ptr != end) {
+            malformed = true;
+            return false;
+          }
+        }
+        if (on_headers) {
+          on_headers(); // may install body_reader (streamBody routes)
+        }
+        if (!body_reader && content_length > MAX_BUFFERED_BODY) {
+          // Only streaming routes may declare a body this large; buffering
+          // it in request.body would hold the whole thing in memory
+          malformed = true;
+          return false;
+        }
+        if (content_length == 0) {
+          state = State::COMPLETE;
+          return true;
+        }
+        state = State::BODY;
+      } else {
+        parseHeaderLine(line_buffer);
+      }
+    }
+    line_buffer.clear();
+  }
+  return false;
+}
+
+void HttpRequestParser::reset() {
+  state = State::REQUEST_LINE;
+  line_buffer.clear();
+  content_length = 0;
+  malformed = false;
+  body_reader = nullptr;
+  body_received = 0;
+  // Clear fields in place rather than reassigning HttpRequest{} - the
+  // header map's inline strings keep their capacity across keep-alive
+  // requests (url/path/version are overwritten by the next request line)
+  request.method = HttpMethod::GET;
+  request.query.clear();
+  request.headers.clear();
+  request.params.clear();
+  request.body.clear();
+}
+
+bool HttpRequestParser::parseRequestLine(const std::string &line) {
+  size_t sp1 = line.find(' ');
+  size_t sp2 = (sp1 == std::string::npos) ? std::string::npos
+                                          : line.find(' ', sp1 + 1);
+  if (sp2 == std::string::npos) {
+    return false;
+  }
+
+  std::string method_str = line.substr(0, sp1);
+  if (method_str == "GET")
+    request.method = HttpMethod::GET;
+  else if (method_str == "POST")
+    request.method = HttpMethod::POST;
+  else if (method_str == "PUT")
+    request.method = HttpMethod::PUT;
+  else if (method_str == "DELETE")
+    request.method = HttpMethod::DELETE;
+  else if (method_str == "HEAD")
+    request.method = HttpMethod::HEAD;
+  else if (method_str == "OPTIONS")
+    request.method = HttpMethod::OPTIONS;
+
+  request.url = line.substr(sp1 + 1, sp2 - sp1 - 1);
+  request.version = line.substr(sp2 + 1);
+  size_t query_pos = request.url.find('?');
+  if (query_pos != std::string::npos) {
+    request.path = request.url.substr(0, query_pos);
+    request.query = request.url.substr(query_pos + 1);
+  } else {
+    request.path = request.url;
+  }
+  return true;
+}
+
+void HttpRequestParser::parseHeaderLine(const std::string &line) {
+  size_t colon_pos = line.find(':');
+  if (colon_pos == std::string::npos) {
+    return;
+  }
+  std::string key = line.substr(0, colon_pos);
+  std::string value = line.substr(colon_pos + 1);
+
+  // Remove leading/trailing whitespace
+  value.erase(0, value.find_first_not_of(" \t"));
+  value.erase(value.find_last_not_of(" \t") + 1);
+
+  request.headers[key] = value;
 }
 
 void HttpServer::handleConnection(Socket &socket) {
-  socket.onData = [this](Socket &socket, const BufferView &data) {
-    std::string data_str(data.data, data.size);
-
-    // Check if this might be a WebSocket upgrade early (before full parsing)
-    if (websocket_server && data_str.find("Upgrade: websocket") != std::string::npos) {
-      // Delegate to WebSocket server's handleConnection which will handle the upgrade
-      websocket_server->handleConnection(socket);
-      // Trigger the WebSocket handler with the data we received
-      if (socket.onData) {
-        socket.onData(socket, data);
+  // One resumable parser per connection, living in the socket's userData
+  // (same pattern as HttpClient/WebSocketClient state)
+  HttpRequestParser *parser = socket.userData.toA<HttpRequestParser>();
+
+  connections[&socket] = SteadyClock::now();
+  startReaper(socket.poller);
+  socket.onClose = [this](Socket &closed) { connections.erase(&closed); };
+
+  socket.onDataChain = [this, parser](Socket &socket,
+                                      const BufferChain &data) {
+    connections[&socket] = SteadyClock::now();
+
+#if USE_AREA_ALLOCATORS
+    // Parse and dispatch under a frame-area context: temporaries built
+    // with the containers.hpp aliases while handling this batch of
+    // requests bump-allocate from the area and are reclaimed wholesale
+    // when it ends. The parser's own state (and anything a handler hands
+    // off, like a deferred response) keeps its heap allocator.
+    FrameAreaScope frame_area;
+#endif
+    // Reinstalled per callback so the closure's socket reference is the
+    // one being dispatched right now
+    parser->on_headers = [this, parser, &socket]() {
+      beginBodyStream(socket, *parser);
+    };
+
+    BufferChain::Cursor cursor(data);
+    while (parser->consume(cursor)) {
+      if (parser->body_reader) {
+        // Streaming upload: the body already went through the reader's
+        // chunk callback; settle the response and move on
+        finishBodyStream(socket, *parser);
+        if (socket.close_after_flush) {
+          return;
+        }
+        parser->reset();
+        continue;
       }
-      return;
+      // Upgrade requests hand the already-parsed request straight to the
+      // WebSocket server, which installs its own data callback - the
+      // handshake bytes are never parsed a second time
+      if (websocket_server && isWebSocketUpgrade(parser->request)) {
+        connections.erase(&socket);
+        socket.onClose = [](Socket &) {};
+        websocket_server->adoptUpgrade(socket, parser->request);
+        return;
+      }
+      handleRequest(socket, parser->request);
+      if (socket.close_after_flush) {
+        return; // connection is closing; drop any pipelined leftovers
+      }
+      parser->reset();
     }
 
-    handleRequest(socket, data_str);
+    // An unusable header block (bad Content-Length) poisons the framing
+    // for everything after it: answer 400 once and close
+    if (parser->malformed && !socket.close_after_flush) {
+      socket.write("HTTP/1.1 400 Bad Request\r\nConnection: close\r\n"
+                   "Content-Length: 0\r\n\r\n");
+      socket.close_after_flush = true;
+    }
   };
 }
 
-void HttpServer::handleRequest(Socket &socket, const std::string &data) {
-  HttpRequest request;
-  HttpResponse response;
+bool HttpServer::shouldKeepAlive(const HttpRequest &request) {
+  const std::string *connection = request.headers.find("Connection");
+  if (connection) {
+    std::string value = *connection;
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    if (value == "close") {
+      return false;
+    }
+    if (value.find("keep-alive") != std::string::npos) {
+      return true;
+    }
+  }
+  return request.version != "HTTP/1.0";
+}
+
+void HttpServer::startReaper(Poller *poller) {
+  if (reaper_timer != 0 || !poller) {
+    return;
+  }
+
+  // Sweep well inside the timeout so a connection is reaped at most ~1.25x
+  // idle_timeout_ms after it went quiet
+  uint32_t sweep_ms = idle_timeout_ms / 4 > 1000 ? idle_timeout_ms / 4 : 1000;
+  reaper_timer = poller->setInterval(sweep_ms, [this]() {
+    SteadyClock::TimePoint now = SteadyClock::now();
+    std::vector<Socket *> expired;
+    for (const auto &entry : connections) {
+      if (SteadyClock::addMilliseconds(entry.second, idle_timeout_ms) <= now) {
+        expired.push_back(entry.first);
+      }
+    }
+    for (Socket *idle : expired) {
+      idle->stop(); // onClose drops it from the map
+    }
+  });
+}
+
+void HttpServer::cacheResponses(const std::string &path, uint32_t ttl_ms) {
+  cached_routes[path] = ttl_ms;
+}
+
+bool HttpServer::respondFromCache(Socket &socket, HttpRequest &request) {
+  const std::string &key = request.query.empty()
+                               ? request.path
+                               : request.path + "?" + request.query;
+
+  auto it = response_cache.find(key);
+  if (it != response_cache.end()) {
+    bool keep_alive = shouldKeepAlive(request);
+    if (it->second.serialized) {
+      // Hit: the preserialized bytes go out through the refcounted
+      // shared-segment path - no handler, no serialization, no copy
+      socket.writeShared(it->second.serialized);
+      if (!keep_alive) {
+        socket.close_after_flush = true;
+      }
+      return true;
+    }
+    // Singleflight: a deferred computation for this key is in flight -
+    // park behind it instead of running the handler again
+    it->second.waiters.push_back({socket.id, keep_alive});
+    return true;
+  }
+
+  // Miss: the caller runs the handler; an entry marked in-flight catches
+  // requests arriving while a deferred computation runs
+  CacheEntry &entry = response_cache[key];
+  entry.in_flight = true;
+  current_cache_key = key;
+  current_cache_ttl = cached_routes[request.path];
+  return false;
+}
+
+void HttpServer::storeCachedResponse(Poller *poller, const std::string &key,
+                                     uint32_t ttl_ms,
+                                     const HttpResponse &response) {
+  auto it = response_cache.find(key);
+  if (it == response_cache.end()) {
+    return; // expired (or evicted) while the computation ran
+  }
+
+  auto serialized = std::make_shared<std::string>();
+  serializeResponse(response, *serialized, /*skip_connection=*/true);
+  serialized->append(response.body);
+
+  it->second.serialized = serialized;
+  it->second.in_flight = false;
+
+  // Answer every request that parked on the singleflight miss; the
+  // generation-checked re-lookup skips connections that died waiting
+  for (const auto &[id, keep_alive] : it->second.waiters) {
+    Socket *waiter = poller ? poller->poolManager.sockets.get(id) : nullptr;
+    if (!waiter || waiter->file_descriptor < 0) {
+      continue;
+    }
+    waiter->writeShared(serialized);
+    if (!keep_alive) {
+      waiter->close_after_flush = true;
+    }
+  }
+  it->second.waiters.clear();
+
+  // TTL expiry rides the timer wheel; the refcounted bytes outlive the
+  // entry for any socket still draining them
+  if (poller) {
+    poller->setTimeout(ttl_ms, [this, key]() { response_cache.erase(key); });
+  }
+}
 
-  // Parse the HTTP request
-  parseRequest(data, request);
+void HttpServer::handleRequest(Socket &socket, HttpRequest &request) {
+  HttpResponse response;
 
   // Set client info
   request.remote_addr = socket.remote_addr;
   request.remote_port = socket.remote_port;
 
-  // Find and execute route handler
-  std::string route_key = findRoute(request.path, request.method);
-  auto it = routes.find(route_key);
+  // Cached route: answer from (or park on) the cache before any routing
+  current_cache_key.clear();
+  if (request.method == HttpMethod::GET && !cached_routes.empty() &&
+      cached_routes.count(request.path) &&
+      respondFromCache(socket, request)) {
+    return;
+  }
 
-  if (it != routes.end()) {
-    it->second(request, response);
-  } else {
+  // Radix-tree match: one walk over the path, ":name" segments land in
+  // request.params
+  Router::Handler *handler = router.find(
+      request.method, request.path.data(), request.path.size(), request.params);
+
+  int static_fd = -1;
+  size_t static_size = 0;
+
+  if (handler) {
+    // Dispatch context for defer()/stream(); valid for the duration of the
+    // handler
+    current_socket = &socket;
+    current_keep_alive = shouldKeepAlive(request);
+    current_deferred = false;
+    current_streaming = false;
+
+    (*handler)(request, response);
+
+    current_socket = nullptr;
+    if (current_deferred) {
+      return; // the HttpDeferred handle owns the response now
+    }
+    if (current_streaming) {
+      // Chunked output has no flat bytes to cache; drop the in-flight mark
+      // so the next request runs the handler again
+      if (!current_cache_key.empty()) {
+        response_cache.erase(current_cache_key);
+        current_cache_key.clear();
+      }
+      // Headers go out now with chunked framing; the HttpStream handle
+      // produces the body and settles the connection's fate in end()
+      response.headers["Transfer-Encoding"] = "chunked";
+      if (!response.headers.contains("Connection")) {
+        response.headers["Connection"] =
+            current_keep_alive ? "keep-alive" : "close";
+      }
+      writeResponse(socket, response);
+      return;
+    }
+    // Synchronous handler on a cached route: preserialize and store (also
+    // answers anything parked, though sync handlers never accumulate
+    // waiters - requests on one poller thread don't interleave)
+    if (!current_cache_key.empty()) {
+      storeCachedResponse(socket.poller, current_cache_key, current_cache_ttl,
+                          response);
+      current_cache_key.clear();
+    }
+  } else if (!serveStaticFile(request, response, &static_fd, &static_size)) {
     // 404 Not Found
     response.status_code = 404;
     response.status_text = "Not Found";
@@ -85,123 +523,365 @@ void HttpServer::handleRequest(Socket &socket, const std::string &data) {
                     "found on this server.</p>";
   }
 
-  // Build and send response
-  std::string http_response = buildResponse(response);
-  socket.write(http_response);
-}
-
-void HttpServer::parseRequest(const std::string &data, HttpRequest &request) {
-  std::istringstream stream(data);
-  std::string line;
-
-  // Parse request line
-  if (std::getline(stream, line)) {
-    std::istringstream line_stream(line);
-    std::string method_str, url, version;
-
-    if (line_stream >> method_str >> url >> version) {
-      // Parse method
-      if (method_str == "GET")
-        request.method = HttpMethod::GET;
-      else if (method_str == "POST")
-        request.method = HttpMethod::POST;
-      else if (method_str == "PUT")
-        request.method = HttpMethod::PUT;
-      else if (method_str == "DELETE")
-        request.method = HttpMethod::DELETE;
-      else if (method_str == "HEAD")
-        request.method = HttpMethod::HEAD;
-      else if (method_str == "OPTIONS")
-        request.method = HttpMethod::OPTIONS;
-
-      // Parse URL
-      request.url = url;
-      size_t query_pos = url.find('?');
-      if (query_pos != std::string::npos) {
-        request.path = url.substr(0, query_pos);
-        request.query = url.substr(query_pos + 1);
-      } else {
-        request.path = url;
-      }
-    }
+  // A cached route that fell through to 404/static handling is not cached;
+  // drop the in-flight mark so the next request retries the lookup
+  if (!current_cache_key.empty()) {
+    response_cache.erase(current_cache_key);
+    current_cache_key.clear();
+  }
+
+  // Announce the connection's fate unless the handler already did
+  bool keep_alive = shouldKeepAlive(request);
+  if (!response.headers.contains("Connection")) {
+    response.headers["Connection"] = keep_alive ? "keep-alive" : "close";
+  }
+
+  // Serialize the header block and send it and the body as separate
+  // appends - the body lands in its own write-buffer slabs and goes out in
+  // the same writev, never copied into the header block
+  writeResponse(socket, response);
+
+  // Large static file: bytes follow the headers straight from the page
+  // cache via sendfile
+  if (static_fd >= 0) {
+    socket.sendFile(static_fd, 0, static_size);
+  }
+
+  if (!keep_alive) {
+    socket.close_after_flush = true; // close once the response is flushed
   }
+}
 
-  // Parse headers
-  while (std::getline(stream, line) && line != "\r" && !line.empty()) {
-    size_t colon_pos = line.find(':');
-    if (colon_pos != std::string::npos) {
-      std::string key = line.substr(0, colon_pos);
-      std::string value = line.substr(colon_pos + 1);
+std::shared_ptr<HttpDeferred> HttpServer::defer(HttpResponse &response) {
+  auto handle = std::make_shared<HttpDeferred>();
+  handle->server = this;
+  handle->poller = current_socket ? current_socket->poller : nullptr;
+  handle->socket_id = current_socket ? current_socket->id : 0;
+  handle->keep_alive = current_keep_alive;
+
+  // On a cached route the handle carries the singleflight key: complete()
+  // stores the response and answers parked requests
+  handle->cache_key = current_cache_key;
+  handle->cache_ttl = current_cache_ttl;
+  current_cache_key.clear();
+
+  response.status = HttpStatus::PENDING;
+  current_deferred = true;
+  return handle;
+}
 
-      // Remove leading/trailing whitespace and \r
-      value.erase(0, value.find_first_not_of(" \t\r"));
-      value.erase(value.find_last_not_of(" \t\r") + 1);
+void HttpDeferred::complete(HttpResponse response) {
+  if (completed.exchange(true)) {
+    return; // already completed
+  }
+  if (!poller) {
+    return;
+  }
 
-      request.headers[key] = value;
+  // Marshal the write back to the poller thread; the response is moved
+  // into shared storage so the posted task stays copyable
+  // Response plus cache coordinates ride in one shared block so the posted
+  // task stays within InplaceFunction's inline capacity
+  struct Completion {
+    HttpResponse response;
+    std::string cache_key;
+    uint32_t cache_ttl;
+  };
+  auto done = std::make_shared<Completion>(
+      Completion{std::move(response), std::move(cache_key), cache_ttl});
+  HttpServer *http_server = server;
+  Poller *target = poller;
+  PollableID id = socket_id;
+  bool ka = keep_alive;
+
+  target->post([http_server, target, id, ka, done]() {
+    HttpResponse *result = &done->response;
+    // A cached route stores the result (and answers requests parked on the
+    // singleflight miss) whether or not the originating socket survived
+    if (!done->cache_key.empty()) {
+      http_server->storeCachedResponse(target, done->cache_key,
+                                       done->cache_ttl, *result);
     }
+    Socket *socket = target->poolManager.sockets.get(id);
+    if (!socket || socket->file_descriptor < 0) {
+      return; // connection went away while the work ran
+    }
+    if (!result->headers.contains("Connection")) {
+      result->headers["Connection"] = ka ? "keep-alive" : "close";
+    }
+    result->status = HttpStatus::COMPLETED;
+    http_server->writeResponse(*socket, *result);
+    if (!ka) {
+      socket->close_after_flush = true;
+    }
+  });
+}
+
+std::shared_ptr<HttpStream> HttpServer::stream(HttpResponse &response) {
+  auto handle = std::make_shared<HttpStream>();
+  handle->server = this;
+  handle->poller = current_socket ? current_socket->poller : nullptr;
+  handle->socket_id = current_socket ? current_socket->id : 0;
+  handle->keep_alive = current_keep_alive;
+
+  // Relay write-buffer drains to the producer for the life of the stream
+  if (current_socket) {
+    current_socket->onDrain = [handle](Socket &) {
+      if (!handle->ended && handle->onDrain) {
+        handle->onDrain();
+      }
+    };
   }
 
-  // Parse body (if any)
-  std::string body;
-  while (std::getline(stream, line)) {
-    body += line + "\n";
+  response.status = HttpStatus::PENDING;
+  current_streaming = true;
+  return handle;
+}
+
+Socket *HttpStream::socketOrNull() {
+  if (!poller) {
+    return nullptr;
   }
-  if (!body.empty()) {
-    request.body = body.substr(0, body.length() - 1); // Remove trailing newline
+  // Generation-checked lookup: a connection that died (and whose slot was
+  // possibly reused) comes back as nullptr instead of a stranger's socket
+  Socket *socket = poller->poolManager.sockets.get(socket_id);
+  if (!socket || socket->file_descriptor < 0) {
+    return nullptr;
   }
+  return socket;
 }
 
-std::string HttpServer::buildResponse(const HttpResponse &response) {
-  std::stringstream ss;
+bool HttpStream::writable() {
+  Socket *socket = socketOrNull();
+  return socket != nullptr && socket->write_buffer.size() < high_watermark;
+}
 
-  // Status line
-  ss << "HTTP/1.1 " << response.status_code << " " << response.status_text
-     << "\r\n";
+bool HttpStream::writeChunk(const BufferView &data) {
+  if (ended || data.size == 0) {
+    return false; // an empty chunk would terminate the stream; use end()
+  }
+  Socket *socket = socketOrNull();
+  if (!socket) {
+    ended = true; // connection went away mid-stream
+    return false;
+  }
 
-  // Headers
-  for (const auto &header : response.headers) {
-    ss << header.first << ": " << header.second << "\r\n";
+  char prefix[20];
+  int len = snprintf(prefix, sizeof(prefix), "%zx\r\n", data.size);
+  socket->write(prefix, static_cast<size_t>(len));
+  socket->write(data.data, data.size);
+  socket->write("\r\n", 2);
+  return true;
+}
+
+void HttpStream::end() {
+  if (ended) {
+    return;
   }
+  ended = true;
 
-  // Content-Length header
-  if (!response.body.empty()) {
-    ss << "Content-Length: " << response.body.length() << "\r\n";
+  Socket *socket = socketOrNull();
+  if (!socket) {
+    return;
+  }
+  socket->write("0\r\n\r\n", 5);
+  socket->onDrain = nullptr;
+  if (!keep_alive) {
+    socket->close_after_flush = true;
   }
+}
 
-  ss << "\r\n";
+void HttpServer::serveStatic(const std::string &url_prefix,
+                             const std::string &directory) {
+  static_mounts.push_back(StaticMount{url_prefix, directory});
+}
 
-  // Body
-  if (!response.body.empty()) {
-    ss << response.body;
+static std::string formatHttpDate(time_t when) {
+  struct tm utc;
+  gmtime_r(&when, &utc);
+  char buf[40];
+  size_t len = strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+  return std::string(buf, len);
+}
+
+bool HttpServer::serveStaticFile(HttpRequest &request, HttpResponse &response,
+                                 int *file_fd, size_t *file_size) {
+  if (request.method != HttpMethod::GET && request.method != HttpMethod::HEAD) {
+    return false;
+  }
+
+  for (const StaticMount &mount : static_mounts) {
+    if (request.path.compare(0, mount.url_prefix.size(), mount.url_prefix) !=
+        0) {
+      continue;
+    }
+
+    std::string rel = request.path.substr(mount.url_prefix.size());
+    if (rel.find("..") != std::string::npos) {
+      continue; // directory traversal attempt
+    }
+    if (rel.empty() || rel == "/") {
+      rel = "/index.html";
+    }
+    if (rel[0] != '/') {
+      rel = "/" + rel;
+    }
+    std::string fs_path = mount.directory + rel;
+
+    struct stat st;
+    if (stat(fs_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+
+    char etag[48];
+    snprintf(etag, sizeof(etag), "\"%zx-%lx\"",
+             static_cast<size_t>(st.st_size), static_cast<long>(st.st_mtime));
+    std::string last_modified = formatHttpDate(st.st_mtime);
+
+    response.headers["ETag"] = etag;
+    response.headers["Last-Modified"] = last_modified;
+
+    // Conditional requests: exact ETag match or the Last-Modified string we
+    // previously handed out
+    const std::string *inm = request.headers.find("If-None-Match");
+    const std::string *ims = request.headers.find("If-Modified-Since");
+    if ((inm && *inm == etag) || (ims && *ims == last_modified)) {
+      response.status_code = 304;
+      response.status_text = "Not Modified";
+      return true;
+    }
+
+    response.headers["Content-Type"] = staticContentType(fs_path);
+
+    if (static_cast<size_t>(st.st_size) >= static_cache.sendfile_threshold) {
+      int fd = open(fs_path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        continue;
+      }
+      response.headers["Content-Length"] =
+          std::to_string(static_cast<size_t>(st.st_size));
+      *file_fd = fd;
+      *file_size = static_cast<size_t>(st.st_size);
+      return true;
+    }
+
+    StaticFileCache::Entry *entry = static_cache.lookup(
+        fs_path, static_cast<size_t>(st.st_size), st.st_mtime);
+    if (!entry) {
+      continue;
+    }
+    response.body.assign(static_cast<const char *>(entry->map), entry->size);
+    return true;
   }
 
-  return ss.str();
+  return false;
+}
+
+// Preserialized status lines for the codes that dominate real traffic;
+// anything else falls back to snprintf composition
+struct StatusLineEntry {
+  int code;
+  const char *reason;
+  const char *line;
+};
+
+static const StatusLineEntry kStatusLines[] = {
+    {200, "OK", "HTTP/1.1 200 OK\r\n"},
+    {201, "Created", "HTTP/1.1 201 Created\r\n"},
+    {204, "No Content", "HTTP/1.1 204 No Content\r\n"},
+    {301, "Moved Permanently", "HTTP/1.1 301 Moved Permanently\r\n"},
+    {302, "Found", "HTTP/1.1 302 Found\r\n"},
+    {304, "Not Modified", "HTTP/1.1 304 Not Modified\r\n"},
+    {400, "Bad Request", "HTTP/1.1 400 Bad Request\r\n"},
+    {401, "Unauthorized", "HTTP/1.1 401 Unauthorized\r\n"},
+    {403, "Forbidden", "HTTP/1.1 403 Forbidden\r\n"},
+    {404, "Not Found", "HTTP/1.1 404 Not Found\r\n"},
+    {500, "Internal Server Error", "HTTP/1.1 500 Internal Server Error\r\n"},
+    {502, "Bad Gateway", "HTTP/1.1 502 Bad Gateway\r\n"},
+    {503, "Service Unavailable", "HTTP/1.1 503 Service Unavailable\r\n"},
+};
+
+// RFC 7231 Date header, regenerated at most once per second and shared by
+// every response built on this poller thread
+static const std::string &dateHeader() {
+  static thread_local time_t cached_second = 0;
+  static thread_local std::string cached = "";
+
+  time_t now = time(nullptr);
+  if (now != cached_second) {
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    char buf[48];
+    size_t len =
+        strftime(buf, sizeof(buf), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &utc);
+    cached.assign(buf, len);
+    cached_second = now;
+  }
+  return cached;
 }
 
-std::string HttpServer::findRoute(const std::string &path, HttpMethod method) {
-  std::string method_str;
-  switch (method) {
-  case HttpMethod::GET:
-    method_str = "GET";
-    break;
-  case HttpMethod::POST:
-    method_str = "POST";
-    break;
-  case HttpMethod::PUT:
-    method_str = "PUT";
-    break;
-  case HttpMethod::DELETE:
-    method_str = "DELETE";
-    break;
-  case HttpMethod::HEAD:
-    method_str = "HEAD";
-    break;
-  case HttpMethod::OPTIONS:
-    method_str = "OPTIONS";
-    break;
+void HttpServer::serializeResponse(const HttpResponse &response,
+                                   std::string &out, bool skip_connection) {
+  // Status line: table hit for common codes with their canonical reason,
+  // composed otherwise
+  const char *preserialized = nullptr;
+  for (const StatusLineEntry &entry : kStatusLines) {
+    if (entry.code == response.status_code &&
+        response.status_text == entry.reason) {
+      preserialized = entry.line;
+      break;
+    }
+  }
+  if (preserialized) {
+    out.append(preserialized);
+  } else {
+    char line[96];
+    int len = snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n",
+                       response.status_code, response.status_text.c_str());
+    out.append(line, len);
+  }
+
+  out.append(dateHeader());
+
+  for (const auto &header : response.headers) {
+    if (skip_connection && header.name == "Connection") {
+      continue; // cached bytes serve every client; fate rides the socket
+    }
+    out.append(header.name);
+    out.append(": ");
+    out.append(header.value);
+    out.append("\r\n");
   }
 
-  return method_str + ":" + path;
+  // Framing: the client needs Content-Length even for an empty body - a
+  // keep-alive response without one (and without Transfer-Encoding) cannot
+  // be delimited, so the peer hangs or reads the next response as body.
+  // Only statuses defined to carry no body at all omit it.
+  bool bodiless_status = response.status_code < 200 ||
+                         response.status_code == 204 ||
+                         response.status_code == 304;
+  if (!bodiless_status) {
+    char length_header[48];
+    int len = snprintf(length_header, sizeof(length_header),
+                       "Content-Length: %zu\r\n", response.body.length());
+    out.append(length_header, len);
+  }
+
+  out.append("\r\n");
+}
+
+void HttpServer::writeResponse(Socket &socket, const HttpResponse &response) {
+  // Reused flat scratch for the header block - no stringstream, no
+  // per-request buffer allocation once it has grown to steady-state size
+  static thread_local std::string header_block = "";
+  header_block.clear();
+
+  serializeResponse(response, header_block);
+
+  socket.write(header_block);
+  if (!response.body.empty()) {
+    socket.write(response.body);
+  }
 }
 
 bool HttpServer::isWebSocketUpgrade(const HttpRequest &request) {
@@ -210,27 +890,27 @@ bool HttpServer::isWebSocketUpgrade(const HttpRequest &request) {
     return false;
   }
 
-  auto upgrade_it = request.headers.find("Upgrade");
-  auto connection_it = request.headers.find("Connection");
-  auto key_it = request.headers.find("Sec-WebSocket-Key");
-  auto version_it = request.headers.find("Sec-WebSocket-Version");
+  const std::string *upgrade_value = request.headers.find("Upgrade");
+  const std::string *connection_value = request.headers.find("Connection");
+  const std::string *key_value = request.headers.find("Sec-WebSocket-Key");
+  const std::string *version_value =
+      request.headers.find("Sec-WebSocket-Version");
 
-  if (upgrade_it == request.headers.end() ||
-      connection_it == request.headers.end() ||
-      key_it == request.headers.end() || version_it == request.headers.end()) {
+  if (!upgrade_value || !connection_value || !key_value || !version_value) {
     return false;
   }
 
   // Check if Upgrade header contains "websocket" (case-insensitive)
-  std::string upgrade = upgrade_it->second;
+  std::string upgrade = *upgrade_value;
   std::transform(upgrade.begin(), upgrade.end(), upgrade.begin(), ::tolower);
 
   // Check if Connection header contains "upgrade" (case-insensitive)
-  std::string connection = connection_it->second;
+  std::string connection = *connection_value;
   std::transform(connection.begin(), connection.end(), connection.begin(),
                  ::tolower);
 
   // Check WebSocket version is 13
-  return upgrade == "websocket" && connection.find("upgrade") != std::string::npos &&
-         version_it->second == "13";
+  return upgrade == "websocket" &&
+         connection.find("upgrade") != std::string::npos &&
+         *version_value == "13";
 }
\ No newline at end of file
@@ -1,45 +1,188 @@
 #pragma once
 
+#include "http_message.hpp"
 #include "listener.hpp"
+#include "router.hpp"
 #include "socket.hpp"
+#include "static_files.hpp"
+#include "steady_clock.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <functional>
 #include <map>
 #include <string>
 
-// Forward declaration
+// Forward declarations
 struct WebSocketServer;
+struct HttpServer;
 
-enum class HttpMethod { GET, POST, PUT, DELETE, HEAD, OPTIONS };
+// Handle for a streaming request body. Routes registered with
+// HttpServer::streamBody() dispatch at end-of-headers instead of after the
+// full body: the handler fills in the two callbacks and decoded body bytes
+// are forwarded chunk by chunk as they arrive, so a multi-GB upload never
+// accumulates in HttpRequest::body - memory per connection stays bounded by
+// one scratch buffer regardless of Content-Length. Returning false from
+// onBodyChunk disables POLLIN on the socket (via Poller::pauseReads); call
+// resume() - on the poller thread, through Poller::post from elsewhere -
+// once the consumer has caught up.
+struct HttpBodyReader {
+  HttpServer *server = nullptr;
+  Poller *poller = nullptr;
+  PollableID socket_id = 0;
+  bool keep_alive = true;
 
-enum class HttpStatus { PENDING, COMPLETED, ERROR };
+  // Decoded body bytes in arrival order; the view is only valid for the
+  // duration of the call. Return false to pause socket reads.
+  std::function<bool(const BufferView &)> onBodyChunk = nullptr;
 
-struct HttpRequest {
-  HttpMethod method = HttpMethod::GET;
-  std::string url = "";
-  std::string path = "/";
-  std::string query = "";
-  std::map<std::string, std::string> headers = {};
-  std::string body = "";
-  std::string remote_addr = "";
-  uint16_t remote_port = 0;
+  // The body is fully received - fill the response like a route handler
+  std::function<void(HttpRequest &, HttpResponse &)> onBodyComplete = nullptr;
+
+  void pause();
+  void resume();
 };
 
-struct HttpResponse {
-  int status_code = 200;
-  std::string status_text = "OK";
-  std::map<std::string, std::string> headers = {};
-  std::string body = "";
-  HttpStatus status = HttpStatus::PENDING;
-  std::string error_message = "";
+// Resumable per-connection request parser (stored in Socket::userData). A
+// connection's bytes are fed in as they arrive - each chunk advances the
+// state machine from wherever the previous chunk left off, so a request
+// line, header, or Content-Length body split across TCP segments is
+// reassembled correctly instead of being re-parsed (or dropped) per chunk.
+struct HttpRequestParser {
+  enum class State { REQUEST_LINE, HEADERS, BODY, COMPLETE };
+
+  State state = State::REQUEST_LINE;
+  std::string line_buffer = ""; // partial request/header line across chunks
+  size_t content_length = 0;
+  HttpRequest request = {};
+
+  // Set when the peer sent an unusable header block (non-numeric or
+  // oversized Content-Length); consume() stops and the server answers 400
+  // and closes. Cleared by reset().
+  bool malformed = false;
+
+  // Largest body consume() will buffer whole in request.body; anything
+  // bigger must go through a streamBody() route, which forwards chunks
+  // without accumulating
+  static constexpr size_t MAX_BUFFERED_BODY = 64 * 1024 * 1024;
+
+  // Fired once per request when the header block is complete, before any
+  // body byte is consumed - the server's chance to divert a matching
+  // streamBody() route into streaming mode
+  std::function<void()> on_headers = nullptr;
+
+  // Streaming mode: when set (by the server from on_headers), body bytes
+  // are forwarded through the reader in bounded slices instead of
+  // accumulating in request.body
+  std::shared_ptr<HttpBodyReader> body_reader = nullptr;
+  size_t body_received = 0;
+
+  // Consume bytes from the cursor; returns true when a complete request is
+  // sitting in `request`. Unconsumed bytes stay on the cursor (pipelining),
+  // so the caller dispatches, calls reset(), and consumes again.
+  bool consume(BufferChain::Cursor &cursor);
+
+  // Ready the parser for the next request on the same connection
+  void reset();
+
+  bool parseRequestLine(const std::string &line);
+  void parseHeaderLine(const std::string &line);
+};
+
+// Completion handle for a deferred response. A handler grabs one with
+// HttpServer::defer(), ships it to an Executor thread (or any other
+// thread), and calls complete() when the result is ready - the write is
+// marshalled back to the poller thread via Poller::post, and the socket is
+// re-looked-up by generation-checked ID so a connection that died in the
+// meantime is simply skipped. complete() is one-shot; extra calls no-op.
+struct HttpDeferred {
+  HttpServer *server = nullptr;
+  Poller *poller = nullptr;
+  PollableID socket_id = 0;
+  bool keep_alive = true;
+  std::atomic<bool> completed{false};
+
+  // Set when the deferring route is cached (HttpServer::cacheResponses):
+  // complete() stores the response under this key and answers any requests
+  // parked on the singleflight miss
+  std::string cache_key = "";
+  uint32_t cache_ttl = 0;
+
+  void complete(HttpResponse response);
+};
+
+// Handle for a streaming response sent with "Transfer-Encoding: chunked".
+// A handler grabs one with HttpServer::stream() - the status line and
+// headers go out when the handler returns, and the body is produced
+// piecewise afterwards with writeChunk(), closed off with end(). The
+// handle reports backpressure from the socket's write-buffer occupancy:
+// when writable() goes false the producer should pause and resume from
+// onDrain, so a multi-hundred-MB export never holds more than one
+// watermark's worth of bytes in memory. All calls belong on the poller
+// thread (drive cross-thread producers through Poller::post).
+struct HttpStream {
+  HttpServer *server = nullptr;
+  Poller *poller = nullptr;
+  PollableID socket_id = 0;
+  bool keep_alive = true;
+  bool ended = false;
+
+  // writable() is false while the socket's write buffer holds at least
+  // this many unsent bytes
+  size_t high_watermark = 256 * 1024;
+
+  // Fired on the poller thread whenever the socket's write buffer fully
+  // drains - the producer's cue to push more chunks
+  std::function<void()> onDrain = nullptr;
+
+  // The live socket, or nullptr if the connection has since gone away
+  Socket *socketOrNull();
+
+  // Whether the socket can absorb more chunks without exceeding the
+  // watermark
+  bool writable();
+
+  // Queue one chunk (hex length prefix + data + CRLF). Returns false if the
+  // stream has ended or the connection is gone; a true return with
+  // writable() false means "accepted, but pause until onDrain"
+  bool writeChunk(const BufferView &data);
+  bool writeChunk(const std::string &data) {
+    return writeChunk(BufferView(data.data(), data.size()));
+  }
+
+  // Send the terminating zero-length chunk and release the connection
+  // (back to keep-alive, or close_after_flush if the request asked to close)
+  void end();
 };
 
 struct HttpServer {
   Listener *listener = nullptr;
-  std::map<std::string, std::function<void(HttpRequest &, HttpResponse &)>>
-      routes = {};
+  Router router = {};
 
   WebSocketServer *websocket_server = nullptr;
 
+  // Static file mounts: URL prefix -> filesystem directory
+  struct StaticMount {
+    std::string url_prefix;
+    std::string directory;
+  };
+  std::vector<StaticMount> static_mounts = {};
+  StaticFileCache static_cache = {};
+
+  // Keep-alive connections and when each was last active, for the idle
+  // reaper. Entries drop out via Socket::onClose.
+  std::map<Socket *, SteadyClock::TimePoint> connections = {};
+  uint32_t idle_timeout_ms = 60 * 1000;
+  uint32_t reaper_timer = 0; // Poller::TimerID, 0 while not started
+
+  // Dispatch context for the handler currently running on the poller
+  // thread (lets defer() find the socket without widening the handler
+  // signature)
+  Socket *current_socket = nullptr;
+  bool current_keep_alive = true;
+  bool current_deferred = false;
+  bool current_streaming = false;
+
   // Constructor - requires a Listener
   HttpServer(Listener *listener);
 
@@ -56,11 +199,112 @@ struct HttpServer {
   void delete_(const std::string &path,
                std::function<void(HttpRequest &, HttpResponse &)> handler);
 
+  // Streaming upload route: the handler runs at end-of-headers with a
+  // HttpBodyReader handle to fill in (see its comment) instead of after the
+  // whole body has been buffered - keep the shared_ptr anywhere resume()
+  // may be called from later. Exact path match - uploads are addressed
+  // endpoints, not parameterized resources.
+  void streamBody(
+      HttpMethod method, const std::string &path,
+      std::function<void(HttpRequest &, std::shared_ptr<HttpBodyReader>)>
+          handler);
+
+  // Cache GET responses for `path` (exact match) for ttl_ms. Entries are
+  // keyed by path+query and hold the fully serialized response bytes in a
+  // refcounted buffer: a hit skips routing, the handler, and serialization
+  // - one map lookup and a zero-copy shared-segment push. Expiry rides the
+  // poller timer wheel. Concurrent misses on one key run the handler
+  // exactly once (singleflight): while a deferred computation is in
+  // flight, later requests park and are answered when complete() lands.
+  // Responses produced with stream() are never cached. The cached bytes
+  // carry the Date of first serialization and no Connection header -
+  // per-request connection fate is handled via close_after_flush.
+  void cacheResponses(const std::string &path, uint32_t ttl_ms);
+
+  // Register a Prometheus text-format scrape endpoint (counters and
+  // histograms aggregated across every live Poller - see metrics.hpp)
+  void enableMetrics(const std::string &path = "/metrics");
+
+  // Called from inside a route handler: marks the response as deferred
+  // (nothing is written when the handler returns) and hands back the
+  // completion handle. Typical use offloads onto poller->executor and
+  // calls handle->complete(response) from the worker thread.
+  std::shared_ptr<HttpDeferred> defer(HttpResponse &response);
+
+  // Called from inside a route handler: switches the response to chunked
+  // framing (headers are written when the handler returns, body must stay
+  // empty) and hands back the streaming handle for writeChunk()/end()
+  std::shared_ptr<HttpStream> stream(HttpResponse &response);
+
+  // Serve files under `directory` for paths starting with `url_prefix`.
+  // Small files come from the mmap cache with ETag/Last-Modified
+  // revalidation; large ones stream zero-copy via Socket::sendFile.
+  void serveStatic(const std::string &url_prefix, const std::string &directory);
+
+  // Response cache state (cacheResponses). cached_routes maps an opted-in
+  // route path to its TTL; response_cache holds one entry per concrete
+  // path+query. An in-flight entry marks a running singleflight miss with
+  // the sockets parked on it (generation-checked IDs plus each request's
+  // keep-alive verdict).
+  struct CacheEntry {
+    std::shared_ptr<const std::string> serialized = nullptr;
+    bool in_flight = false;
+    std::vector<std::pair<PollableID, bool>> waiters = {};
+  };
+  std::map<std::string, uint32_t> cached_routes = {};
+  std::map<std::string, CacheEntry> response_cache = {};
+
+  // Cache key of the request currently dispatching (empty when the route
+  // is not cached) - picked up after the handler returns, or carried by
+  // the HttpDeferred handle for async completions
+  std::string current_cache_key = "";
+  uint32_t current_cache_ttl = 0;
+
+  // Streaming upload routes, matched at end-of-headers
+  struct BodyRoute {
+    HttpMethod method;
+    std::string path;
+    std::function<void(HttpRequest &, std::shared_ptr<HttpBodyReader>)> handler;
+  };
+  std::vector<BodyRoute> body_routes = {};
+
   // Internal methods
   void handleConnection(Socket &socket);
-  void handleRequest(Socket &socket, const std::string &data);
-  void parseRequest(const std::string &data, HttpRequest &request);
-  std::string buildResponse(const HttpResponse &response);
-  std::string findRoute(const std::string &path, HttpMethod method);
+  void handleRequest(Socket &socket, HttpRequest &request);
+  // streamBody dispatch: divert the parser into streaming mode when a
+  // route matches / settle the response once the body has fully streamed
+  void beginBodyStream(Socket &socket, HttpRequestParser &parser);
+  void finishBodyStream(Socket &socket, HttpRequestParser &parser);
+  // Serialize the response flat (preserialized status lines, cached Date
+  // header) and queue header block and body as separate writes so they go
+  // out in one writev without concatenation
+  void writeResponse(Socket &socket, const HttpResponse &response);
+  // The header-block serialization writeResponse is built on: status line
+  // through the terminating blank line, appended to `out` (also used to
+  // preserialize cache entries, which tack the body on after). Skips the
+  // Connection header when skip_connection is set.
+  void serializeResponse(const HttpResponse &response, std::string &out,
+                         bool skip_connection = false);
+  // Response cache internals: try to answer (or park) the request from the
+  // cache - a false return means "miss, run the handler" with
+  // current_cache_key set; store then serializes the computed response,
+  // answers parked waiters, and schedules expiry
+  bool respondFromCache(Socket &socket, HttpRequest &request);
+  void storeCachedResponse(Poller *poller, const std::string &key,
+                           uint32_t ttl_ms, const HttpResponse &response);
+
   bool isWebSocketUpgrade(const HttpRequest &request);
+
+  // Resolve a request against the static mounts; fills response (304 or
+  // cached body) or hands back an open fd + size for the sendfile path.
+  // Returns false if no mount matches.
+  bool serveStaticFile(HttpRequest &request, HttpResponse &response,
+                       int *file_fd, size_t *file_size);
+
+  // HTTP/1.1 defaults to keep-alive, HTTP/1.0 to close; an explicit
+  // Connection header wins either way
+  bool shouldKeepAlive(const HttpRequest &request);
+
+  // Start the periodic idle-connection sweep (first connection kicks it off)
+  void startReaper(Poller *poller);
 };
\ No newline at end of file
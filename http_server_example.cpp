@@ -70,8 +70,8 @@ int main() {
                     "<ul>";
 
     for (const auto &header : request.headers) {
-      response.body += "<li><strong>" + header.first + ":</strong> " +
-                       header.second + "</li>";
+      response.body += "<li><strong>" + header.name + ":</strong> " +
+                       header.value + "</li>";
     }
 
     response.body += "</ul>";
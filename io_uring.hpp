@@ -0,0 +1,214 @@
+#pragma once
+
+// Minimal raw-syscall io_uring wrapper used by the Poller's IO_URING backend.
+// We intentionally avoid a liburing dependency: only the small subset needed
+// for batched readiness polling (POLL_ADD/POLL_REMOVE) is implemented here.
+// Guarded so the tree still builds on systems without io_uring kernel headers.
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define WEB_SERVER_HAS_IO_URING 1
+
+#include <cstdint>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// The kernel uapi headers leak a BLOCK_SIZE macro (via linux/fs.h) that
+// collides with user code
+#ifdef BLOCK_SIZE
+#undef BLOCK_SIZE
+#endif
+
+struct IoUring {
+  int ring_fd = -1;
+
+  // Submission queue (mapped from the kernel)
+  unsigned *sq_head = nullptr;
+  unsigned *sq_tail = nullptr;
+  unsigned sq_ring_mask = 0;
+  unsigned *sq_array = nullptr;
+  struct io_uring_sqe *sqes = nullptr;
+  unsigned sq_entries = 0;
+  unsigned sq_to_submit = 0; // SQEs prepared since the last enter()
+
+  // Completion queue (mapped from the kernel)
+  unsigned *cq_head = nullptr;
+  unsigned *cq_tail = nullptr;
+  unsigned cq_ring_mask = 0;
+  struct io_uring_cqe *cqes = nullptr;
+
+  void *sq_ring_ptr = nullptr;
+  size_t sq_ring_size = 0;
+  void *cq_ring_ptr = nullptr;
+  size_t cq_ring_size = 0;
+  size_t sqes_size = 0;
+
+  bool ext_arg_supported = false; // IORING_FEAT_EXT_ARG (wait with timeout)
+
+  bool init(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd < 0) {
+      return false;
+    }
+
+    ext_arg_supported = (params.features & IORING_FEAT_EXT_ARG) != 0;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      if (cq_ring_size > sq_ring_size) {
+        sq_ring_size = cq_ring_size;
+      }
+      cq_ring_size = sq_ring_size;
+    }
+
+    sq_ring_ptr = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr == MAP_FAILED) {
+      sq_ring_ptr = nullptr;
+      shutdown();
+      return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ring_ptr = sq_ring_ptr;
+    } else {
+      cq_ring_ptr =
+          mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (cq_ring_ptr == MAP_FAILED) {
+        cq_ring_ptr = nullptr;
+        shutdown();
+        return false;
+      }
+    }
+
+    char *sq = static_cast<char *>(sq_ring_ptr);
+    sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_ring_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries = params.sq_entries;
+
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes_ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes_ptr == MAP_FAILED) {
+      shutdown();
+      return false;
+    }
+    sqes = static_cast<struct io_uring_sqe *>(sqes_ptr);
+
+    char *cq = static_cast<char *>(cq_ring_ptr);
+    cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_ring_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    return true;
+  }
+
+  void shutdown() {
+    if (sqes) {
+      munmap(sqes, sqes_size);
+      sqes = nullptr;
+    }
+    if (cq_ring_ptr && cq_ring_ptr != sq_ring_ptr) {
+      munmap(cq_ring_ptr, cq_ring_size);
+    }
+    cq_ring_ptr = nullptr;
+    if (sq_ring_ptr) {
+      munmap(sq_ring_ptr, sq_ring_size);
+      sq_ring_ptr = nullptr;
+    }
+    if (ring_fd != -1) {
+      close(ring_fd);
+      ring_fd = -1;
+    }
+  }
+
+  bool initialized() const { return ring_fd != -1; }
+
+  // Grab the next free SQE, or nullptr if the ring is full
+  struct io_uring_sqe *getSqe() {
+    unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *sq_tail;
+    if (tail - head >= sq_entries) {
+      return nullptr;
+    }
+
+    unsigned index = tail & sq_ring_mask;
+    struct io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    sq_to_submit++;
+    return sqe;
+  }
+
+  static void preparePollAdd(struct io_uring_sqe *sqe, int fd, short events,
+                             uint64_t user_data) {
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll_events = static_cast<uint16_t>(events);
+    sqe->user_data = user_data;
+  }
+
+  static void preparePollRemove(struct io_uring_sqe *sqe, uint64_t target,
+                                uint64_t user_data) {
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = target; // user_data of the POLL_ADD to cancel
+    sqe->user_data = user_data;
+  }
+
+  // Submit all prepared SQEs in a single syscall and (optionally) wait for at
+  // least one completion, bounded by timeout_ms. Returns the enter() result.
+  int submitAndWait(unsigned min_complete, int timeout_ms) {
+    unsigned to_submit = sq_to_submit;
+    sq_to_submit = 0;
+
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    if (min_complete > 0 && timeout_ms >= 0 && ext_arg_supported) {
+      struct __kernel_timespec ts;
+      ts.tv_sec = timeout_ms / 1000;
+      ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+
+      struct io_uring_getevents_arg arg;
+      memset(&arg, 0, sizeof(arg));
+      arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+      return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                          flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                        flags, nullptr, 0);
+  }
+
+  // Peek the next completion without consuming it; returns false if empty
+  bool peekCqe(struct io_uring_cqe **cqe_out) {
+    unsigned head = *cq_head;
+    unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      return false;
+    }
+    *cqe_out = &cqes[head & cq_ring_mask];
+    return true;
+  }
+
+  void advanceCqe() { __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE); }
+};
+
+#else
+#define WEB_SERVER_HAS_IO_URING 0
+#endif
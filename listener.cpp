@@ -1,43 +1,122 @@
 #include "listener.hpp"
 #include "poller.hpp"
+#if USE_AREA_ALLOCATORS
+#include "poller_memory.hpp"
+#endif
 #include <arpa/inet.h>
+#include <cstring>
+#include <errno.h>
 #include <iostream>
+#include <sys/un.h>
 
 Listener::Listener() : Pollable() {
   type = PollableType::LISTENER;
   port = 0;
 
   onEvent = [this](short revents) {
-    if (file_descriptor >= 0) {
-      struct sockaddr_in client_addr;
+    if (file_descriptor < 0) {
+      std::cout << "Listener stopped" << std::endl;
+      return;
+    }
+
+    // Accept until the backlog is empty. accept4 hands the fd back already
+    // non-blocking, saving the fcntl round-trip per connection that the
+    // old accept + setNonBlocking pair paid.
+    Socket *batch[ACCEPT_BATCH];
+    size_t count = 0;
+    for (;;) {
+      // Accept-rate governor: a false return parked our POLLIN until the
+      // token bucket refills - the kernel backlog absorbs the burst
+      if (!poller->governorShouldAccept(id)) {
+        break;
+      }
+
+      struct sockaddr_storage client_addr;
       socklen_t client_len = sizeof(client_addr);
       int client_fd =
-          accept(file_descriptor, (struct sockaddr *)&client_addr, &client_len);
-      if (client_fd >= 0) {
-        std::cout << "New connection accepted from "
-                  << inet_ntoa(client_addr.sin_addr) << ":"
-                  << ntohs(client_addr.sin_port) << " (fd: " << client_fd << ")"
-                  << std::endl;
-
-        Socket *client_socket = poller->createSocket();
-        client_socket->file_descriptor = client_fd;
-        client_socket->remote_addr = inet_ntoa(client_addr.sin_addr);
-        client_socket->remote_port = ntohs(client_addr.sin_port);
+          accept4(file_descriptor, (struct sockaddr *)&client_addr,
+                  &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (client_fd < 0) {
+        poller->governorRefundAccept(); // nothing was accepted for the token
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR &&
+            errno != ECONNABORTED) {
+          std::cerr << "Failed to accept connection" << std::endl;
+        }
+        break;
+      }
 
-        onAccept(client_socket);
+      // Connection-cap governor: shed the newest connection (LIFO) with a
+      // preserialized 503 - or nothing at all - before any pool slot,
+      // buffer, or parsing is spent on it
+      if (!poller->governorAdmit()) {
+        if (poller->governor_shed_with_503) {
+          static const char k503[] =
+              "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n"
+              "Content-Length: 0\r\n\r\n";
+          (void)::send(client_fd, k503, sizeof(k503) - 1, MSG_NOSIGNAL);
+        }
+        close(client_fd);
+        continue;
+      }
 
+      Socket *client_socket = poller->createSocket();
+      client_socket->file_descriptor = client_fd;
+      if (client_addr.ss_family == AF_UNIX) {
+        // Unix peers are usually unnamed; the listening path identifies the
+        // transport well enough for logs and bookkeeping
+        client_socket->remote_addr = unix_path;
+        client_socket->remote_port = 0;
+        client_socket->unix_domain = true;
+        client_socket->applyUnixBufferSizes();
       } else {
-        std::cerr << "Failed to accept connection" << std::endl;
+        struct sockaddr_in *inet_addr = (struct sockaddr_in *)&client_addr;
+        client_socket->remote_addr = inet_ntoa(inet_addr->sin_addr);
+        client_socket->remote_port = ntohs(inet_addr->sin_port);
       }
-    } else {
-      std::cout << "Listener stopped" << std::endl;
+
+#if USE_AREA_ALLOCATORS
+      // Give the connection its own bump area for request-lifetime
+      // allocations; Poller::removePollable hands it back
+      client_socket->connection_area =
+          get_poller_memory_areas()->allocate_connection_area();
+#endif
+
+      batch[count++] = client_socket;
+      if (count == ACCEPT_BATCH) {
+        dispatchAccepted(batch, count);
+        count = 0;
+        if (file_descriptor < 0) {
+          return; // a callback stopped the listener
+        }
+      }
+    }
+
+    if (count > 0) {
+      dispatchAccepted(batch, count);
     }
   };
 }
 
-bool Listener::start(uint16_t port) {
+void Listener::dispatchAccepted(Socket *const *batch, size_t count) {
+  std::cout << "Accepted " << count << " connection"
+            << (count == 1 ? "" : "s") << " (first from "
+            << batch[0]->remote_addr << ":" << batch[0]->remote_port << ")"
+            << std::endl;
+  if (onAcceptMany) {
+    onAcceptMany(std::span<Socket *const>(batch, count));
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      onAccept(batch[i]);
+    }
+  }
+}
+
+bool Listener::start(uint16_t port, bool reuse_port) {
   this->port = port;
-  file_descriptor = socket(AF_INET, SOCK_STREAM, 0);
+  // Non-blocking listener: the accept loop drains until EAGAIN, which only
+  // terminates if the fd itself never blocks
+  file_descriptor =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
   if (file_descriptor < 0)
     return false;
 
@@ -48,6 +127,13 @@ bool Listener::start(uint16_t port) {
     return false;
   }
 
+  if (reuse_port &&
+      setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) <
+          0) {
+    close(file_descriptor);
+    return false;
+  }
+
   struct sockaddr_in addr;
   addr.sin_family = AF_INET;
   addr.sin_addr.s_addr = INADDR_ANY;
@@ -66,10 +152,61 @@ bool Listener::start(uint16_t port) {
   return true;
 }
 
+bool Listener::startUnix(const std::string &path) {
+  file_descriptor =
+      socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    std::cerr << "Unix socket path too long: " << path << std::endl;
+    return false;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  // A previous run's socket file would make bind fail with EADDRINUSE even
+  // though nothing is listening; replace it (a live listener still conflicts
+  // - its bound inode is gone but it keeps accepting until stopped)
+  unlink(path.c_str());
+
+  if (bind(file_descriptor, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    return false;
+  }
+
+  if (::listen(file_descriptor, SOMAXCONN) < 0) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    return false;
+  }
+
+  unix_path = path;
+  return true;
+}
+
+bool Listener::adopt(int fd, uint16_t port) {
+  if (fd < 0) {
+    return false;
+  }
+  file_descriptor = fd;
+  this->port = port;
+  return true;
+}
+
 void Listener::stop() {
 
   if (file_descriptor >= 0) {
     close(file_descriptor);
     file_descriptor = -1;
   }
+  if (!unix_path.empty()) {
+    unlink(unix_path.c_str());
+    unix_path.clear();
+  }
 }
@@ -4,17 +4,57 @@
 #include "socket.hpp"
 #include <functional>
 #include <netinet/in.h>
+#include <span>
 #include <sys/socket.h>
 #include <unistd.h>
 
 struct Listener : Pollable {
+  // Connections accepted per dispatch to onAcceptMany. One POLLIN wakeup
+  // keeps accepting until EAGAIN, so a reconnect storm is cleared in
+  // ceil(backlog / ACCEPT_BATCH) callback invocations instead of one
+  // wakeup per connection.
+  static constexpr size_t ACCEPT_BATCH = 64;
+
   using AcceptCallback = std::function<void(Socket *)>;
   AcceptCallback onAccept = [](Socket *) {};
+
+  // Batched alternative to onAccept: when set, freshly accepted sockets are
+  // delivered ACCEPT_BATCH at a time and onAccept is not called. The span is
+  // only valid for the duration of the callback.
+  using AcceptManyCallback = std::function<void(std::span<Socket *const>)>;
+  AcceptManyCallback onAcceptMany = nullptr;
+
   uint16_t port = 0;
 
+  // Bound filesystem path when listening on a unix domain socket (empty for
+  // TCP); unlinked again by stop()
+  std::string unix_path = "";
+
   Listener();
 
-  bool start(uint16_t port);
+  // Start listening on the given port. When reuse_port is true the socket is
+  // bound with SO_REUSEPORT so several listeners (one per Poller shard) can
+  // share the port and let the kernel load-balance incoming connections.
+  bool start(uint16_t port, bool reuse_port = false);
+
+  // Listen on a unix domain socket at `path` (SOCK_STREAM). Same-host
+  // clients skip the TCP/IP stack entirely - no checksums, no loopback
+  // routing - and everything built on Socket (HttpServer, WebSocketServer)
+  // works over it unchanged. A stale socket file at `path` is replaced;
+  // accepted sockets get enlarged kernel buffers (Socket::UNIX_BUFFER_SIZE)
+  // and support fd passing via Socket::sendFds / onFdReceived.
+  bool startUnix(const std::string &path);
+
+  // Take over an already-listening fd received from another process (warm
+  // restart, see warm_restart.hpp). The open file description keeps its
+  // bound address, O_NONBLOCK mode, and - crucially - its listen queue, so
+  // accepting resumes exactly where the sending process left off.
+  bool adopt(int fd, uint16_t port);
 
   void stop();
+
+private:
+  // Route one accepted batch to onAcceptMany, or fan out to onAccept when
+  // no batch callback is installed
+  void dispatchAccepted(Socket *const *batch, size_t count);
 };
\ No newline at end of file
@@ -1,29 +1,231 @@
 #pragma once
-#include <iostream>
-#include <sstream>
-
-// Simple logging macros
-#define LOG(...) do { \
-    std::ostringstream oss; \
-    log_impl(oss, __VA_ARGS__); \
-    std::cout << oss.str() << std::endl; \
-} while(0)
-
-#define LOG_ERROR(...) do { \
-    std::ostringstream oss; \
-    oss << "[ERROR] "; \
-    log_impl(oss, __VA_ARGS__); \
-    std::cerr << oss.str() << std::endl; \
-} while(0)
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// Asynchronous logger. The old macros built an ostringstream and flushed
+// through std::endl on the calling thread - a heap allocation plus a
+// syscall per message, sitting directly in hot paths. Now a call site
+// formats into a preallocated record in a thread-local bounded ring (no
+// heap, no lock - the caller is the ring's only producer) and a single
+// background thread drains every ring and does the actual writes. A full
+// ring drops the message and counts the drop rather than ever stalling
+// the event loop.
+//
+// Levels: LOG_DEBUG < LOG < LOG_ERROR. Sites below WEB_SERVER_LOG_LEVEL
+// compile away entirely; compiled-in sites pay one relaxed load and
+// branch against the runtime level before touching the ring, so release
+// builds can keep LOG sites present but disabled for free.
+
+enum class LogLevel : uint8_t { DEBUG = 0, INFO = 1, ERROR = 2, OFF = 3 };
+
+// Compile-time floor: 0 keeps LOG_DEBUG, 1 (default) keeps LOG and
+// LOG_ERROR, 2 keeps only LOG_ERROR, 3 strips all logging
+#ifndef WEB_SERVER_LOG_LEVEL
+#define WEB_SERVER_LOG_LEVEL 1
+#endif
+
+// Fixed-capacity streambuf over a record's inline text buffer; overlong
+// messages truncate instead of allocating
+struct LogStreamBuf : std::streambuf {
+  LogStreamBuf(char *buffer, size_t capacity) {
+    setp(buffer, buffer + capacity);
+  }
+  size_t used() const { return pptr() - pbase(); }
+};
+
+// Single-producer (owning thread) / single-consumer (writer thread) ring
+// of fixed records
+struct LogRing {
+  static constexpr size_t CAPACITY = 1024; // power of two
+  static constexpr size_t MASK = CAPACITY - 1;
+  static constexpr size_t TEXT_SIZE = 232;
+
+  struct Record {
+    uint8_t level = 0;
+    uint16_t length = 0;
+    char text[TEXT_SIZE];
+  };
+
+  std::array<Record, CAPACITY> records = {};
+  std::atomic<uint64_t> head{0}; // consumer (writer thread)
+  std::atomic<uint64_t> tail{0}; // producer (owning thread)
+  std::atomic<uint64_t> dropped{0};
+};
+
+class AsyncLogger {
+public:
+  std::atomic<uint8_t> min_level{static_cast<uint8_t>(LogLevel::DEBUG)};
+
+  static AsyncLogger &instance() {
+    static AsyncLogger logger;
+    return logger;
+  }
+
+  // The calling thread's ring, created and registered on first use
+  LogRing &threadRing() {
+    static thread_local std::shared_ptr<LogRing> ring = registerRing();
+    return *ring;
+  }
+
+  // Runtime floor (compile-time elision is WEB_SERVER_LOG_LEVEL)
+  void setLevel(LogLevel level) {
+    min_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+  }
+
+  // Drain everything currently queued - useful in tests that assert on
+  // output; the destructor calls it for a clean shutdown
+  void flush() {
+    std::vector<std::shared_ptr<LogRing>> snapshot;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      snapshot = rings;
+    }
+    for (auto &ring : snapshot) {
+      drainRing(*ring);
+    }
+    std::fflush(stdout);
+    std::fflush(stderr);
+  }
+
+  ~AsyncLogger() {
+    running.store(false);
+    condition.notify_all();
+    if (writer.joinable()) {
+      writer.join();
+    }
+    flush();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::shared_ptr<LogRing>> rings;
+  std::thread writer;
+  std::atomic<bool> running{false};
+
+  AsyncLogger() {
+    running.store(true);
+    writer = std::thread([this]() { writerLoop(); });
+  }
+
+  std::shared_ptr<LogRing> registerRing() {
+    auto ring = std::make_shared<LogRing>();
+    std::lock_guard<std::mutex> lock(mutex);
+    rings.push_back(ring);
+    return ring;
+  }
+
+  void drainRing(LogRing &ring) {
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    while (head != tail) {
+      LogRing::Record &record = ring.records[head & LogRing::MASK];
+      bool is_error = record.level >= static_cast<uint8_t>(LogLevel::ERROR);
+      FILE *out = is_error ? stderr : stdout;
+      if (is_error) {
+        std::fwrite("[ERROR] ", 1, 8, out);
+      }
+      std::fwrite(record.text, 1, record.length, out);
+      std::fputc('\n', out);
+      head++;
+    }
+    ring.head.store(head, std::memory_order_release);
+
+    uint64_t drops = ring.dropped.exchange(0, std::memory_order_relaxed);
+    if (drops > 0) {
+      std::fprintf(stderr, "[ERROR] logger dropped %llu messages\n",
+                   static_cast<unsigned long long>(drops));
+    }
+  }
+
+  void writerLoop() {
+    while (running.load()) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, std::chrono::milliseconds(2));
+      }
+      std::vector<std::shared_ptr<LogRing>> snapshot;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = rings;
+      }
+      bool wrote = false;
+      for (auto &ring : snapshot) {
+        uint64_t before = ring->head.load(std::memory_order_relaxed);
+        drainRing(*ring);
+        wrote |= ring->head.load(std::memory_order_relaxed) != before;
+      }
+      if (wrote) {
+        std::fflush(stdout);
+      }
+    }
+  }
+};
 
 // Helper function to handle variadic arguments
-template<typename T>
-void log_impl(std::ostringstream& oss, T&& arg) {
-    oss << arg;
+template <typename T> void log_impl(std::ostream &os, T &&arg) { os << arg; }
+
+template <typename T, typename... Args>
+void log_impl(std::ostream &os, T &&first, Args &&...args) {
+  os << first;
+  log_impl(os, args...);
 }
 
-template<typename T, typename... Args>
-void log_impl(std::ostringstream& oss, T&& first, Args&&... args) {
-    oss << first;
-    log_impl(oss, args...);
-}
\ No newline at end of file
+template <typename... Args>
+inline void web_server_log(LogLevel level, Args &&...args) {
+  AsyncLogger &logger = AsyncLogger::instance();
+  if (static_cast<uint8_t>(level) <
+      logger.min_level.load(std::memory_order_relaxed)) {
+    return; // the single branch a disabled-but-compiled-in site pays
+  }
+
+  LogRing &ring = logger.threadRing();
+  uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  uint64_t head = ring.head.load(std::memory_order_acquire);
+  if (tail - head >= LogRing::CAPACITY) {
+    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+    return; // never stall the caller on a full ring
+  }
+
+  LogRing::Record &record = ring.records[tail & LogRing::MASK];
+  LogStreamBuf buf(record.text, LogRing::TEXT_SIZE);
+  std::ostream os(&buf);
+  log_impl(os, std::forward<Args>(args)...);
+  record.length = static_cast<uint16_t>(buf.used());
+  record.level = static_cast<uint8_t>(level);
+  ring.tail.store(tail + 1, std::memory_order_release);
+}
+
+#if WEB_SERVER_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) web_server_log(LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)                                                         \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#if WEB_SERVER_LOG_LEVEL <= 1
+#define LOG(...) web_server_log(LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG(...)                                                               \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#if WEB_SERVER_LOG_LEVEL <= 2
+#define LOG_ERROR(...) web_server_log(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)                                                         \
+  do {                                                                         \
+  } while (0)
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hot-path metrics. Each poller thread owns one PollerMetrics block and is
+// its only writer, so every update is a relaxed fetch_add on memory no other
+// core writes - a few nanoseconds, cheap enough to leave on in production.
+// The blocks are cache-line aligned so two pollers never share a line, and
+// aggregation happens only when something scrapes /metrics: the reader sums
+// relaxed loads across registered blocks. Counters may be mutually slightly
+// stale under load; scrape output is a snapshot, not a transaction.
+
+// Fixed-bucket latency histogram: power-of-two microsecond buckets from
+// <1us to <32ms plus overflow. record() is two relaxed adds and a
+// find-first-set - no allocation, no locks.
+struct LatencyHistogram {
+  static constexpr size_t BUCKETS = 16;
+
+  std::array<std::atomic<uint64_t>, BUCKETS> buckets = {};
+  std::atomic<uint64_t> sum_us{0};
+  std::atomic<uint64_t> count{0};
+
+  void record(uint64_t us) {
+    size_t bucket = 0;
+    uint64_t bound = 1;
+    while (bucket < BUCKETS - 1 && us >= bound) {
+      bound <<= 1;
+      bucket++;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(us, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Upper bound of bucket i in microseconds (last bucket is +inf)
+  static uint64_t upperBoundUs(size_t bucket) { return 1ull << bucket; }
+};
+
+// One block per poller thread, single writer
+struct alignas(64) PollerMetrics {
+  // Times the wait syscall (poll/epoll_wait/io_uring enter) returned
+  std::atomic<uint64_t> poll_wakeups{0};
+  // Pollable event callbacks dispatched
+  std::atomic<uint64_t> events_dispatched{0};
+  // Payload bytes moved through sockets
+  std::atomic<uint64_t> bytes_read{0};
+  std::atomic<uint64_t> bytes_written{0};
+  // Timer callbacks fired (timeouts and interval ticks)
+  std::atomic<uint64_t> timer_fires{0};
+  // Cross-thread tasks drained from the posted queue
+  std::atomic<uint64_t> posted_tasks{0};
+
+  // Time spent dispatching one wakeup's worth of events (measured once per
+  // wakeup, not per event, so the clock cost amortizes across the batch)
+  LatencyHistogram dispatch_latency = {};
+
+  inline void countWakeup() {
+    poll_wakeups.fetch_add(1, std::memory_order_relaxed);
+  }
+  inline void countEvents(uint64_t n) {
+    events_dispatched.fetch_add(n, std::memory_order_relaxed);
+  }
+  inline void countBytesRead(uint64_t n) {
+    bytes_read.fetch_add(n, std::memory_order_relaxed);
+  }
+  inline void countBytesWritten(uint64_t n) {
+    bytes_written.fetch_add(n, std::memory_order_relaxed);
+  }
+  inline void countTimerFire() {
+    timer_fires.fetch_add(1, std::memory_order_relaxed);
+  }
+  inline void countPostedTask() {
+    posted_tasks.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+struct Poller;
+
+// Process-wide list of live poller metric blocks. Registration happens in
+// the Poller constructor/destructor (cold path, mutex-guarded); scraping
+// walks the list and sums. Executor queue depth is read straight off each
+// poller at scrape time rather than counted.
+struct MetricsRegistry {
+  std::mutex mutex = {};
+  std::vector<Poller *> pollers = {};
+
+  static MetricsRegistry &instance() {
+    static MetricsRegistry registry;
+    return registry;
+  }
+
+  void add(Poller *poller) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pollers.push_back(poller);
+  }
+
+  void remove(Poller *poller) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < pollers.size(); i++) {
+      if (pollers[i] == poller) {
+        pollers.erase(pollers.begin() + i);
+        break;
+      }
+    }
+  }
+
+  // Render every metric in Prometheus text exposition format, aggregated
+  // across pollers (defined at the bottom of poller.hpp - it reads poller
+  // state, and defining it here would need a circular include)
+  std::string renderPrometheus();
+};
@@ -0,0 +1,223 @@
+// Microbenchmarks for the core primitives on the request hot path.
+//
+// Times each function in isolation - no sockets, no syscalls - so a change
+// to Buffer, the frame codec, the request parser, or the area allocator
+// shows up as a number instead of an argument. Each benchmark calibrates
+// its iteration count until the measured window is long enough to trust,
+// then prints ns/op and the implied throughput; run it on the base commit
+// and the change and diff the table.
+//
+// The barriers below are the usual ones: doNotOptimize() forces the
+// compiler to consider a value used, clobberMemory() forces queued stores
+// to happen - without them dead-code elimination turns a benchmark body
+// into nothing.
+
+#include "area_allocator.hpp"
+#include "buffer.hpp"
+#include "buffer_chain.hpp"
+#include "http_server.hpp"
+#include "poller.hpp"
+#include "websocket_server.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+template <typename T> inline void doNotOptimize(T &value) {
+  asm volatile("" : "+m,r"(value) : : "memory");
+}
+
+inline void clobberMemory() { asm volatile("" ::: "memory"); }
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Runs body(iterations) in growing batches until the window is at least
+// 200ms, so ns/op has enough samples to be stable across runs
+template <typename Body>
+void runBench(const char *name, size_t bytes_per_op, Body &&body) {
+  constexpr uint64_t MIN_WINDOW_NS = 200 * 1000 * 1000;
+
+  uint64_t iterations = 1000;
+  uint64_t elapsed_ns = 0;
+  for (;;) {
+    uint64_t begin = nowNs();
+    body(iterations);
+    elapsed_ns = nowNs() - begin;
+    if (elapsed_ns >= MIN_WINDOW_NS) {
+      break;
+    }
+    iterations *= 4;
+  }
+
+  double ns_per_op = static_cast<double>(elapsed_ns) / iterations;
+  double mb_per_s =
+      bytes_per_op > 0
+          ? (bytes_per_op * iterations) / (elapsed_ns / 1e9) / (1024.0 * 1024.0)
+          : 0;
+  printf("%-28s %10.1f ns/op %8zu bytes/op %10.1f MB/s %12llu iters\n", name,
+         ns_per_op, bytes_per_op, mb_per_s,
+         static_cast<unsigned long long>(iterations));
+}
+
+// A masked client->server frame, built by hand so this file doesn't need
+// the client header (it defines the same frame types as the server's)
+std::vector<uint8_t> buildMaskedFrame(const std::string &payload) {
+  std::vector<uint8_t> frame;
+  frame.push_back(0x81); // FIN + TEXT
+  const uint8_t key[4] = {0xde, 0xad, 0xbe, 0xef};
+  if (payload.size() < 126) {
+    frame.push_back(0x80 | static_cast<uint8_t>(payload.size()));
+  } else {
+    frame.push_back(0x80 | 126);
+    frame.push_back((payload.size() >> 8) & 0xff);
+    frame.push_back(payload.size() & 0xff);
+  }
+  frame.insert(frame.end(), key, key + 4);
+  for (size_t i = 0; i < payload.size(); i++) {
+    frame.push_back(static_cast<uint8_t>(payload[i]) ^ key[i % 4]);
+  }
+  return frame;
+}
+
+void benchBufferAppend() {
+  Buffer buffer;
+  char chunk[64];
+  memset(chunk, 'x', sizeof(chunk));
+  runBench("buffer_append_64", sizeof(chunk), [&](uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+      buffer.append(chunk, sizeof(chunk));
+      if (buffer.size() >= 1024 * 1024) {
+        buffer.clear(); // amortized: one clear per 16K appends
+      }
+      clobberMemory();
+    }
+  });
+}
+
+void benchBufferGetAt() {
+  Buffer buffer;
+  char chunk[1024];
+  memset(chunk, 'y', sizeof(chunk));
+  for (int i = 0; i < 64; i++) {
+    buffer.append(chunk, sizeof(chunk)); // 64KB across several slabs
+  }
+  const size_t mask = buffer.size() - 1; // 64KB, power of two
+  runBench("buffer_get_at", 1, [&](uint64_t iterations) {
+    unsigned sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+      sum += static_cast<unsigned char>(buffer.getAt(i & mask));
+    }
+    doNotOptimize(sum);
+  });
+}
+
+void benchAreaAllocate() {
+  constexpr size_t POOL_SIZE = 256 * 1024;
+  std::vector<char> pool(POOL_SIZE);
+  AreaAllocatorBase area(pool.data(), POOL_SIZE, "micro_bench");
+  constexpr size_t ALLOC_SIZE = 64;
+  size_t since_reset = 0;
+  runBench("area_allocate_raw_64", ALLOC_SIZE, [&](uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+      void *ptr = area.allocate_raw(ALLOC_SIZE, 8);
+      doNotOptimize(ptr);
+      if (++since_reset * ALLOC_SIZE >= POOL_SIZE) {
+        area.reset(); // stay inside the pool, off the overflow path
+        since_reset = 0;
+      }
+    }
+  });
+}
+
+void benchWsBuildFrame() {
+  String payload(512, 'x');
+  runBench("ws_build_frame_text_512", payload.size(),
+           [&](uint64_t iterations) {
+             for (uint64_t i = 0; i < iterations; i++) {
+               Vector<uint8_t> frame = WebSocketConnection::buildFrame(
+                   payload, WebSocketOpcode::TEXT);
+               doNotOptimize(frame);
+             }
+           });
+}
+
+void benchWsDecodeFrame() {
+  std::vector<uint8_t> wire = buildMaskedFrame(std::string(512, 'x'));
+  BufferChain chain(
+      BufferView{reinterpret_cast<char *>(wire.data()), wire.size()});
+  WebSocketConnection connection;
+  runBench("ws_decode_frame_text_512", wire.size(), [&](uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+      BufferChain::Cursor cursor(chain);
+      bool ok = connection.decodeFrame(cursor, connection.frame_scratch);
+      doNotOptimize(ok);
+    }
+  });
+}
+
+void benchHttpParseRequest() {
+  const char *raw = "GET /api/users/42?page=3 HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "User-Agent: micro_bench/1.0\r\n"
+                    "Accept: application/json\r\n"
+                    "Connection: keep-alive\r\n"
+                    "\r\n";
+  size_t raw_size = strlen(raw);
+  BufferChain chain(BufferView{const_cast<char *>(raw), raw_size});
+  HttpRequestParser parser;
+  runBench("http_parse_request", raw_size, [&](uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+      parser.reset();
+      BufferChain::Cursor cursor(chain);
+      bool complete = parser.consume(cursor);
+      doNotOptimize(complete);
+    }
+  });
+}
+
+void benchHttpWriteResponse(Poller &poller) {
+  // An unstarted listener and a connectionless socket: writeResponse only
+  // touches the socket's write buffer, which is cleared every iteration
+  HttpServer server(poller.createListener());
+  Socket *socket = poller.createSocket();
+
+  HttpResponse response;
+  response.status_code = 200;
+  response.status_text = "OK";
+  response.headers["Content-Type"] = "application/json";
+  response.headers["Cache-Control"] = "no-store";
+  response.body = std::string(512, 'x');
+
+  size_t bytes_per_op = response.body.size() + 128; // approx. header block
+  runBench("http_write_response_512", bytes_per_op, [&](uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+      server.writeResponse(*socket, response);
+      socket->write_buffer.clear();
+      clobberMemory();
+    }
+  });
+}
+
+} // namespace
+
+int main() {
+  printf("%-28s %16s %17s %15s %18s\n", "benchmark", "time", "size",
+         "throughput", "iterations");
+
+  benchBufferAppend();
+  benchBufferGetAt();
+  benchAreaAllocate();
+  benchWsBuildFrame();
+  benchWsDecodeFrame();
+  benchHttpParseRequest();
+
+  Poller poller; // gives writeResponse a socket to serialize into
+  benchHttpWriteResponse(poller);
+
+  return 0;
+}
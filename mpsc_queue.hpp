@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+// Lock-free multi-producer single-consumer queue (Treiber stack with a FIFO
+// reversal on drain). Producers push with a single CAS loop and never block;
+// the consumer detaches the whole list with one exchange and processes it
+// without touching the shared head again. Used to hand work from Executor
+// worker threads back to the poller thread.
+template <typename T> struct MpscQueue {
+  struct Node {
+    T value;
+    Node *next = nullptr;
+  };
+
+  std::atomic<Node *> head{nullptr};
+
+  ~MpscQueue() {
+    drain([](T &&) {});
+  }
+
+  // Safe to call from any thread
+  void push(T value) {
+    Node *node = new Node{std::move(value), nullptr};
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) == nullptr;
+  }
+
+  // Consumer only: detach everything pushed so far and invoke fn on each
+  // item in push order
+  template <typename Fn> void drain(Fn &&fn) {
+    Node *node = head.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack comes out newest-first; reverse it so tasks run in the order
+    // they were posted
+    Node *prev = nullptr;
+    while (node) {
+      Node *next = node->next;
+      node->next = prev;
+      prev = node;
+      node = next;
+    }
+
+    while (prev) {
+      Node *next = prev->next;
+      fn(std::move(prev->value));
+      delete prev;
+      prev = next;
+    }
+  }
+};
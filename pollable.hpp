@@ -2,9 +2,41 @@
 #include <cstdint>
 #include <functional>
 
+// Slot-map encoded pollable IDs: [generation:10][index:20][pool:2].
+// The index addresses a dense slot array, the pool bits separate the socket,
+// listener, and datagram index spaces, and the generation catches stale IDs
+// whose slot has been recycled since.
 using PollableID = uint32_t;
 
-enum class PollableType { SOCKET, LISTENER, TIMER };
+constexpr uint32_t POLLABLE_INDEX_BITS = 20;
+constexpr uint32_t POLLABLE_INDEX_MASK = (1u << POLLABLE_INDEX_BITS) - 1;
+constexpr uint32_t POLLABLE_POOL_BITS = 2;
+constexpr uint32_t POLLABLE_POOL_MASK = (1u << POLLABLE_POOL_BITS) - 1;
+constexpr uint32_t POLLABLE_POOL_SHIFT = 0;
+constexpr uint32_t POLLABLE_INDEX_SHIFT = POLLABLE_POOL_BITS;
+constexpr uint32_t POLLABLE_GEN_SHIFT = POLLABLE_INDEX_BITS + POLLABLE_POOL_BITS;
+constexpr uint32_t POLLABLE_GEN_MASK = (1u << 10) - 1;
+
+// Index of the slot inside its pool
+inline uint32_t pollableSlotIndex(PollableID id) {
+  return (id >> POLLABLE_INDEX_SHIFT) & POLLABLE_INDEX_MASK;
+}
+
+// Index + pool bits: unique key across the pools (22 bits). The pool bits
+// sit low so the keys of the pools interleave - a table addressed by slot
+// key stays as small as the number of live pollables
+inline uint32_t pollableSlotKey(PollableID id) {
+  return id & ((1u << POLLABLE_GEN_SHIFT) - 1);
+}
+
+inline PollableID makePollableID(uint32_t generation, uint32_t pool_tag,
+                                 uint32_t index) {
+  return ((generation & POLLABLE_GEN_MASK) << POLLABLE_GEN_SHIFT) |
+         ((index & POLLABLE_INDEX_MASK) << POLLABLE_INDEX_SHIFT) |
+         ((pool_tag & POLLABLE_POOL_MASK) << POLLABLE_POOL_SHIFT);
+}
+
+enum class PollableType { SOCKET, LISTENER, TIMER, DATAGRAM };
 
 class Poller;
 struct Pollable {
@@ -20,9 +52,3 @@ struct Pollable {
   EventCallback onEvent = [](short revents) {};
   StopFunction stopFunction = []() {};
 };
-
-class PollableIDManager {
-public:
-  uint32_t next_id = 0;
-  PollableID allocate() { return next_id++; }
-};
\ No newline at end of file
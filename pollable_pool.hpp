@@ -1,22 +1,79 @@
 #pragma once
 
 #include "pollable.hpp"
-#include <map>
+#include <deque>
+#include <vector>
 
+// Generation-checked slot map for pollables: slots are addressed directly by
+// the index bits of the PollableID (no tree or hash lookup), freed slots are
+// recycled through a free list, and the generation bits of the ID detect
+// stale handles to recycled slots. std::deque keeps element addresses stable
+// across growth, so Socket*/Listener* handed out to callers stay valid.
 template <typename T> struct PollablePool {
-  std::map<PollableID, T> items = {};
+  struct Slot {
+    T item = {};
+    uint32_t generation = 0;
+    bool occupied = false;
+  };
 
-  T *create(PollableIDManager *idManager) {
-    PollableID id = idManager->allocate();
-    T &item = items[id];
-    item.id = id;
-    return &item;
+  uint32_t pool_tag = 0; // separates the index spaces of the pools
+  std::deque<Slot> slots = {};
+  std::vector<uint32_t> free_indices = {};
+
+  PollablePool(uint32_t tag = 0) : pool_tag(tag) {}
+
+  T *create() {
+    uint32_t index;
+    if (!free_indices.empty()) {
+      index = free_indices.back();
+      free_indices.pop_back();
+    } else {
+      index = static_cast<uint32_t>(slots.size());
+      slots.emplace_back();
+    }
+
+    Slot &slot = slots[index];
+    slot.occupied = true;
+    slot.item.id = makePollableID(slot.generation, pool_tag, index);
+    return &slot.item;
   }
 
-  void destroy(PollableID id) { items.erase(id); }
+  void destroy(PollableID id) {
+    Slot *slot = findSlot(id);
+    if (!slot) {
+      return;
+    }
+
+    slot->occupied = false;
+    slot->generation++; // invalidates every outstanding ID for this slot
+
+    // Re-construct in place so the recycled object starts clean (the default
+    // callbacks capture the object's own address, so assignment won't do)
+    slot->item.~T();
+    new (&slot->item) T();
+
+    free_indices.push_back(pollableSlotIndex(id));
+  }
 
   T *get(PollableID id) {
-    auto it = items.find(id);
-    return it != items.end() ? &it->second : nullptr;
+    Slot *slot = findSlot(id);
+    return slot ? &slot->item : nullptr;
+  }
+
+private:
+  Slot *findSlot(PollableID id) {
+    if (((id >> POLLABLE_POOL_SHIFT) & POLLABLE_POOL_MASK) != pool_tag) {
+      return nullptr; // ID belongs to another pool
+    }
+    uint32_t index = pollableSlotIndex(id);
+    if (index >= slots.size()) {
+      return nullptr;
+    }
+    Slot &slot = slots[index];
+    if (!slot.occupied ||
+        slot.generation != ((id >> POLLABLE_GEN_SHIFT) & POLLABLE_GEN_MASK)) {
+      return nullptr; // stale ID - slot was recycled
+    }
+    return &slot;
   }
-};
\ No newline at end of file
+};
@@ -1,16 +1,15 @@
 #pragma once
+#include "datagram_socket.hpp"
 #include "listener.hpp"
 #include "pollable.hpp"
 #include "pollable_pool.hpp"
 #include "socket.hpp"
 #include <cstdint>
-#include <map>
 
 struct PollablePoolManager {
   void stop() {}
 
-  PollableIDManager id_manager = PollableIDManager{};
-
-  PollablePool<Socket> sockets = PollablePool<Socket>{};
-  PollablePool<Listener> listeners = PollablePool<Listener>{};
-};
\ No newline at end of file
+  PollablePool<Socket> sockets = PollablePool<Socket>{0};
+  PollablePool<Listener> listeners = PollablePool<Listener>{1};
+  PollablePool<DatagramSocket> datagrams = PollablePool<DatagramSocket>{2};
+};
@@ -1,77 +1,492 @@
 #include "poller.hpp"
 #include "log.hpp"
+#if USE_AREA_ALLOCATORS
+#include "poller_memory.hpp"
+#endif
 #include <algorithm>
+#include <csignal>
 #include <fcntl.h>
 #include <iostream>
 #include <limits>
 #include <mutex>
+#include <sys/eventfd.h>
 #include <thread>
 
+#if WEB_SERVER_HAS_IO_URING
+// user_data markers for io_uring entries that don't belong to a pollable
+static constexpr uint64_t kUringEventFdData = ~0ull;
+static constexpr uint64_t kUringCancelData = ~0ull - 1;
+#endif
+
+// epoll user_data marker for the notification eventfd. epoll_data is a
+// union, so the eventfd must be tagged in the same field (u32) the pollables
+// use - comparing data.fd against the eventfd number can false-match a
+// pollable whose ID happens to equal that fd
+static constexpr uint32_t kEpollEventFdData = ~0u;
+
 // Factory methods
 Listener *Poller::createListener() {
-  Listener *listener = poolManager.listeners.create(&poolManager.id_manager);
+  Listener *listener = poolManager.listeners.create();
   addPollable(listener);
   return listener;
 }
 
 Socket *Poller::createSocket() {
-  Socket *socket = poolManager.sockets.create(&poolManager.id_manager);
+  Socket *socket = poolManager.sockets.create();
   addPollable(socket);
+  socket_count++;
   return socket;
 }
 
+DatagramSocket *Poller::createDatagramSocket() {
+  DatagramSocket *datagram_socket = poolManager.datagrams.create();
+  addPollable(datagram_socket);
+  return datagram_socket;
+}
+
 void Poller::addPollable(Pollable *pollable) {
   if (!pollable)
     return;
   pollable->poller = this;
-  pollEntries[pollable->id] = PollEntry{pollable, POLLIN};
+  pollEntries.insert(pollable->id, PollEntry{pollable, POLLIN});
+
+  // For the epoll backends the fd is registered once instead of being
+  // re-submitted every loop iteration. The fd is usually not assigned yet at
+  // this point (accept()/connect() happen later), so queue the pollable and
+  // let the loop register it as soon as the fd becomes valid.
+  if (backend != PollerBackend::POLL) {
+    epoll_pending_registration.push_back(pollable->id);
+  }
 }
 
 void Poller::removePollable(PollableID id) {
-  auto it = pollEntries.find(id);
-  if (it != pollEntries.end()) {
-    pollEntries.erase(it);
+  PollEntry *entry = pollEntries.find(id);
+  if (entry) {
+    // Deregister from epoll before the fd is lost
+    if (epoll_fd != -1 && entry->pollable->file_descriptor >= 0) {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, entry->pollable->file_descriptor,
+                nullptr);
+    }
+#if WEB_SERVER_HAS_IO_URING
+    // Cancel any outstanding POLL_ADD for this pollable
+    if (uring.initialized() && entry->armed) {
+      auto *sqe = uring.getSqe();
+      if (sqe) {
+        IoUring::preparePollRemove(sqe, id, kUringCancelData);
+      }
+    }
+#endif
+#if USE_AREA_ALLOCATORS
+    // Hand the connection's bump area back to the pool
+    if (entry->pollable->type == PollableType::SOCKET) {
+      Socket *socket = static_cast<Socket *>(entry->pollable);
+      if (socket->connection_area) {
+        get_poller_memory_areas()->free_connection_area(
+            socket->connection_area);
+        socket->connection_area = nullptr;
+      }
+    }
+#endif
+    pollEntries.erase(id);
   }
 
+  epoll_pending_registration.erase(
+      std::remove(epoll_pending_registration.begin(),
+                  epoll_pending_registration.end(), id),
+      epoll_pending_registration.end());
+
   // Remove from pools
+  if (poolManager.sockets.get(id) && socket_count > 0) {
+    socket_count--;
+  }
   poolManager.sockets.destroy(id);
   poolManager.listeners.destroy(id);
+  poolManager.datagrams.destroy(id);
 }
 
 void Poller::enablePollout(PollableID socket_id) {
   pollout_pending[socket_id] = true;
 }
 
+void Poller::scheduleFlush(PollableID socket_id) {
+  flush_pending.push_back(socket_id);
+}
+
+void Poller::pauseReads(PollableID socket_id) {
+  PollEntry *entry = pollEntries.find(socket_id);
+  if (!entry || !(entry->events & POLLIN)) {
+    return;
+  }
+  entry->events &= ~POLLIN;
+  applyEventMaskChange(socket_id, *entry);
+}
+
+void Poller::resumeReads(PollableID socket_id) {
+  PollEntry *entry = pollEntries.find(socket_id);
+  if (!entry || (entry->events & POLLIN)) {
+    return;
+  }
+  entry->events |= POLLIN;
+  applyEventMaskChange(socket_id, *entry);
+}
+
+void Poller::applyEventMaskChange(PollableID id, PollEntry &entry) {
+  if (backend == PollerBackend::EPOLL ||
+      backend == PollerBackend::EPOLL_EDGE_TRIGGERED) {
+    // EPOLL_CTL_MOD re-evaluates readiness, so restoring POLLIN redelivers
+    // buffered bytes even on the edge-triggered backend
+    if (entry.pollable->file_descriptor >= 0 &&
+        std::find(epoll_pending_registration.begin(),
+                  epoll_pending_registration.end(),
+                  id) == epoll_pending_registration.end()) {
+      epollUpdateEntry(id, entry, EPOLL_CTL_MOD);
+    }
+  }
+#if WEB_SERVER_HAS_IO_URING
+  else if (backend == PollerBackend::IO_URING) {
+    if (entry.armed) {
+      // Cancel the outstanding POLL_ADD; its completion queues a rearm
+      // which picks up the new mask (same dance as the POLLOUT path)
+      auto *sqe = uring.getSqe();
+      if (sqe) {
+        IoUring::preparePollRemove(sqe, id, kUringCancelData);
+      }
+    } else if (std::find(uring_rearm.begin(), uring_rearm.end(), id) ==
+               uring_rearm.end()) {
+      uring_rearm.push_back(id);
+    }
+  }
+#endif
+  // POLL backend: the pollfd array is rebuilt from entry.events every
+  // iteration, nothing to sync
+}
+
+// Field-for-field capture of a live connection while it hops between
+// pollers (Poller::migrate): built on the source thread, consumed by a
+// posted task on the target's. onEvent and stopFunction are deliberately
+// not carried - the fresh slot's defaults bind to the new object, which is
+// also why sockets with a replaced onEvent (TLS) cannot migrate.
+struct SocketMigration {
+  int fd = -1;
+  std::string remote_addr = "";
+  uint16_t remote_port = 0;
+  bool drain_reads = true;
+  Buffer write_buffer = Buffer{};
+  std::deque<Socket::SharedSegment> shared_queue = {};
+  Any userData;
+  Socket::Callback onData;
+  Socket::ChainCallback onDataChain;
+  Socket::ConnectCallback onConnect;
+  Socket::CloseCallback onClose;
+  Socket::DrainCallback onDrain;
+  size_t drain_threshold = 0;
+  bool close_after_flush = false;
+  int sendfile_fd = -1;
+  off_t sendfile_offset = 0;
+  size_t sendfile_remaining = 0;
+  Poller::MigrateCallback on_migrated = nullptr;
+};
+
+bool Poller::migrate(PollableID socket_id, Poller &target,
+                     MigrateCallback on_migrated) {
+  if (&target == this) {
+    return false; // nothing to rebalance
+  }
+  PollEntry *entry = pollEntries.find(socket_id);
+  if (!entry || entry->pollable->type != PollableType::SOCKET) {
+    return false;
+  }
+  Socket *socket = static_cast<Socket *>(entry->pollable);
+  if (socket->file_descriptor < 0 || socket->connect_pending) {
+    return false; // closed, or a connect whose completion is loop-local
+  }
+
+  // Capture everything that defines the connection. Moving the Any keeps
+  // its heap block, so protocol state the moved callbacks point into
+  // (parsers, client objects in userData) stays at the same address.
+  // read_buffer is not carried: every dispatch drains it to the callbacks,
+  // so between events it holds nothing.
+  auto carrier = std::make_shared<SocketMigration>();
+  carrier->fd = socket->file_descriptor;
+  carrier->remote_addr = std::move(socket->remote_addr);
+  carrier->remote_port = socket->remote_port;
+  carrier->drain_reads = socket->drain_reads;
+  carrier->write_buffer = std::move(socket->write_buffer);
+  carrier->shared_queue = std::move(socket->shared_queue);
+  carrier->userData = std::move(socket->userData);
+  carrier->onData = std::move(socket->onData);
+  carrier->onDataChain = std::move(socket->onDataChain);
+  carrier->onConnect = std::move(socket->onConnect);
+  carrier->onClose = std::move(socket->onClose);
+  carrier->onDrain = std::move(socket->onDrain);
+  carrier->drain_threshold = socket->drain_threshold;
+  carrier->close_after_flush = socket->close_after_flush;
+  carrier->sendfile_fd = socket->sendfile_fd;
+  carrier->sendfile_offset = socket->sendfile_offset;
+  carrier->sendfile_remaining = socket->sendfile_remaining;
+  carrier->on_migrated = std::move(on_migrated);
+
+  // Quiesce: withdraw the fd from this loop's event set without closing
+  // it. Events already harvested this iteration no-op against the cleared
+  // fd (Socket::onEvent guards on file_descriptor >= 0), and the POLL
+  // backend's per-iteration rebuild hands poll() a negative fd, which the
+  // kernel skips.
+  if (epoll_fd != -1) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket->file_descriptor, nullptr);
+  }
+#if WEB_SERVER_HAS_IO_URING
+  if (uring.initialized() && entry->armed) {
+    auto *sqe = uring.getSqe();
+    if (sqe) {
+      IoUring::preparePollRemove(sqe, socket_id, kUringCancelData);
+    }
+    entry->armed = false;
+  }
+#endif
+  socket->file_descriptor = -1;
+  socket->sendfile_fd = -1; // ownership moved with the carrier
+  socket->sendfile_remaining = 0;
+  pollout_pending.erase(socket_id);
+
+  // The vacated slot dies in the cleanup phase, same deferral as stop()
+  // but without the close or the onClose - the connection is moving, not
+  // ending - so a handler migrating the socket it is running on stays safe
+  cleanupTasks.push_back([this, socket_id]() { removePollable(socket_id); });
+
+  // Land on the target's thread through its post queue: a fresh pool slot
+  // takes over the fd, and the registration queued by addPollable arms it
+  // once the target loop sees the now-valid fd
+  Poller *dest = &target;
+  target.post([carrier, dest]() {
+    Socket *fresh = dest->createSocket();
+    fresh->file_descriptor = carrier->fd;
+    fresh->remote_addr = std::move(carrier->remote_addr);
+    fresh->remote_port = carrier->remote_port;
+    fresh->drain_reads = carrier->drain_reads;
+    fresh->write_buffer = std::move(carrier->write_buffer);
+    fresh->shared_queue = std::move(carrier->shared_queue);
+    fresh->userData = std::move(carrier->userData);
+    fresh->onData = std::move(carrier->onData);
+    fresh->onDataChain = std::move(carrier->onDataChain);
+    fresh->onConnect = std::move(carrier->onConnect);
+    fresh->onClose = std::move(carrier->onClose);
+    fresh->onDrain = std::move(carrier->onDrain);
+    fresh->drain_threshold = carrier->drain_threshold;
+    fresh->close_after_flush = carrier->close_after_flush;
+    fresh->sendfile_fd = carrier->sendfile_fd;
+    fresh->sendfile_offset = carrier->sendfile_offset;
+    fresh->sendfile_remaining = carrier->sendfile_remaining;
+    if (fresh->wantsPollout()) {
+      fresh->requestFlush(); // resume the interrupted write stream
+    }
+    if (carrier->on_migrated) {
+      carrier->on_migrated(*fresh);
+    }
+  });
+  return true;
+}
+
+void Poller::processPendingFlushes() {
+  // Indexed loop: a flush callback (onDrain) may write again and append to
+  // flush_pending while we iterate
+  for (size_t i = 0; i < flush_pending.size(); ++i) {
+    PollableID id = flush_pending[i];
+    PollEntry *entry = pollEntries.find(id);
+    if (!entry || entry->pollable->type != PollableType::SOCKET) {
+      continue; // Removed since it was scheduled
+    }
+    Socket *socket = static_cast<Socket *>(entry->pollable);
+    socket->flush_scheduled = false;
+    if (socket->file_descriptor < 0) {
+      continue;
+    }
+    if (socket->connect_pending) {
+      // A synthetic POLLOUT would be taken as connect completion; let the
+      // real kernel event flush once the handshake finishes
+      enablePollout(id);
+      continue;
+    }
+
+    // Deliver as a synthetic POLLOUT through onEvent rather than calling
+    // flushWriteBuffer directly, so wrapped handlers (TLS) run their own
+    // write path
+    entry->pollable->onEvent(POLLOUT);
+
+    // Kernel pushed back (or a wrapped handler left bytes queued): fall
+    // through to the normal POLLOUT arming for the remainder
+    entry = pollEntries.find(id);
+    if (entry && entry->pollable->file_descriptor >= 0 &&
+        static_cast<Socket *>(entry->pollable)->wantsPollout()) {
+      enablePollout(id);
+    }
+  }
+  flush_pending.clear();
+}
+
 void Poller::notify() {
   // If called from the same thread as the poller, do nothing
   if (std::this_thread::get_id() == poller_thread_id) {
     return;
   }
 
-  // Write a byte to the notification pipe to wake up poll()
-  if (hasNotificationPipe()) {
-    char byte = 1;
+  // Bump the eventfd counter to wake up the poll/epoll wait. The kernel
+  // coalesces concurrent writes, so a burst of notifies costs one wakeup.
+  if (hasNotificationEventFd()) {
+    uint64_t one = 1;
 
-    if (write(notification_pipe[1], &byte, 1) == -1) {
+    if (write(notification_event_fd, &one, sizeof(one)) == -1) {
       // Handle error but don't throw - this might be called from signal
       // handlers
-      LOG_ERROR("Failed to write to notification pipe: ", strerror(errno));
+      LOG_ERROR("Failed to write to notification eventfd: ", strerror(errno));
     }
   }
 }
 
+void Poller::post(Task task) {
+  posted_tasks.push(std::move(task));
+  notify();
+}
+
+void Poller::drainPostedTasks() {
+  posted_tasks.drain([this](Task &&task) {
+    metrics.countPostedTask();
+    task();
+  });
+}
+
 void Poller::setMaxPollTimeout(int max_timeout_ms) {
   max_poll_timeout_ms = std::max(2000, max_timeout_ms);
 }
 
+void Poller::enableBusyPoll(int window_us, int streak, int decay) {
+  busy_poll_enabled = true;
+  busy_poll_window_us = std::max(1, window_us);
+  busy_poll_streak = std::max(1, streak);
+  busy_poll_decay = std::max(1, decay);
+}
+
+void Poller::enableGovernor(size_t max_connections, size_t write_buffer_cap,
+                            uint32_t write_cap_grace_ms,
+                            uint32_t accept_rate) {
+  governor_enabled = true;
+  governor_max_connections = max_connections;
+  governor_write_buffer_cap = write_buffer_cap;
+  governor_write_cap_grace_ms = std::max(governor_sweep_interval_ms,
+                                         write_cap_grace_ms);
+  governor_accept_rate = accept_rate;
+  governor_accept_tokens = accept_rate; // start with a full bucket
+  governor_token_refill = SteadyClock::now();
+
+  if (governor_write_buffer_cap > 0 && governor_timer == 0) {
+    governor_timer = setInterval(governor_sweep_interval_ms,
+                                 [this]() { governorSweep(); });
+  }
+}
+
+bool Poller::governorShouldAccept(PollableID listener_id) {
+  if (!governor_enabled || governor_accept_rate == 0) {
+    return true;
+  }
+
+  // Token bucket with one second of burst, refilled by wall-clock elapsed
+  // time so the rate holds regardless of wakeup cadence
+  SteadyClock::TimePoint now = SteadyClock::now();
+  int elapsed_ms = SteadyClock::durationMs(governor_token_refill, now);
+  governor_token_refill = now;
+  governor_accept_tokens =
+      std::min(static_cast<double>(governor_accept_rate),
+               governor_accept_tokens +
+                   governor_accept_rate * (elapsed_ms / 1000.0));
+
+  if (governor_accept_tokens >= 1.0) {
+    governor_accept_tokens -= 1.0;
+    return true;
+  }
+
+  // Bucket dry: park the listener's POLLIN so the loop doesn't spin on a
+  // backlog it refuses to drain, and wake it when a token is due
+  pauseReads(listener_id);
+  uint32_t wait_ms = static_cast<uint32_t>(
+      (1.0 - governor_accept_tokens) * 1000.0 / governor_accept_rate) + 1;
+  setTimeout(wait_ms, [this, listener_id]() { resumeReads(listener_id); });
+  return false;
+}
+
+void Poller::governorSweep() {
+  if (governor_write_buffer_cap == 0) {
+    return;
+  }
+  // How many consecutive over-cap sweeps exhaust the grace period
+  uint32_t max_sweeps =
+      governor_write_cap_grace_ms / governor_sweep_interval_ms;
+
+  pollEntries.forEach([this, max_sweeps](PollableID, PollEntry &entry) {
+    if (entry.pollable->type != PollableType::SOCKET) {
+      return;
+    }
+    Socket *socket = static_cast<Socket *>(entry.pollable);
+    if (socket->file_descriptor < 0) {
+      return;
+    }
+    if (socket->pendingBytes() <= governor_write_buffer_cap) {
+      socket->over_cap_sweeps = 0;
+      return;
+    }
+    socket->over_cap_sweeps++;
+    if (socket->over_cap_sweeps >= max_sweeps) {
+      // The peer has not drained below the cap for the whole grace period:
+      // a slow (or stalled) reader holding buffer memory hostage. Evict.
+      LOG_ERROR("[Governor] Evicting slow client ", socket->remote_addr, ":",
+                socket->remote_port, " (", socket->pendingBytes(),
+                " bytes queued)");
+      socket->stop();
+    }
+  });
+}
+
+int Poller::busyPollTimeout(int timeout_ms) {
+  if (!busy_poll_enabled || busy_poll_credit_us <= 0) {
+    return timeout_ms;
+  }
+  // Spin: ask the kernel for whatever is ready right now and come straight
+  // back. Timers and posted tasks still run at the top of every iteration.
+  busy_poll_wait_start = SteadyClock::now();
+  return 0;
+}
+
+void Poller::busyPollRecord(int result) {
+  if (!busy_poll_enabled) {
+    return;
+  }
+
+  if (result > 0) {
+    // Events are arriving close together - (re)fill the spin budget once the
+    // streak is long enough to suggest more are coming
+    if (++busy_poll_hits >= busy_poll_streak) {
+      busy_poll_credit_us = busy_poll_window_us;
+    }
+    return;
+  }
+
+  busy_poll_hits = 0;
+  if (busy_poll_credit_us > 0) {
+    // Idle spin - charge the elapsed wall time (scaled by the decay factor)
+    // against the budget so a quiet connection stops burning CPU quickly
+    int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             SteadyClock::now() - busy_poll_wait_start)
+                             .count();
+    busy_poll_credit_us -= std::max<int64_t>(1, elapsed_us) * busy_poll_decay;
+  }
+}
+
 void Poller::updatePollEvents() {
   for (auto &entry : pollout_pending) {
     auto socket_id = entry.first;
     auto &pending = entry.second;
     if (pending) {
-      auto it = pollEntries.find(socket_id);
-      if (it != pollEntries.end()) {
-        it->second.events |= POLLOUT;
+      PollEntry *poll_entry = pollEntries.find(socket_id);
+      if (poll_entry) {
+        poll_entry->events |= POLLOUT;
         pending = false;
       }
     }
@@ -81,45 +496,68 @@ void Poller::updatePollEvents() {
 void Poller::start() {
   running = true;
 
+  // A peer that resets mid-transfer turns the next writev into SIGPIPE,
+  // which would kill the whole process; ignore it and let the write path
+  // see EPIPE instead (the socket then tears down normally)
+  signal(SIGPIPE, SIG_IGN);
+
   // Capture the poller thread ID
   poller_thread_id = std::this_thread::get_id();
 
-  // Create notification pipe at start
-  createNotificationPipe();
+  // Create notification eventfd at start
+  createNotificationEventFd();
 
+  if (backend == PollerBackend::POLL) {
+    runPollLoop();
+  } else if (backend == PollerBackend::IO_URING) {
+    runIoUringLoop();
+  } else {
+    runEpollLoop();
+  }
+}
+
+void Poller::runPollLoop() {
   while (running) {
-    // Process any expired timers first
+    // Run tasks posted from other threads first
+    drainPostedTasks();
+
+    // Process any expired timers
     processExpiredTimers();
 
+    // Flush writes queued by posted tasks and timer callbacks before waiting
+    processPendingFlushes();
+
     // Update poll events for any pending POLLOUT requests
     updatePollEvents();
 
     // Calculate timeout based on next timer expiry
     current_poll_timeout_ms = calculatePollTimeout();
 
-    // Rebuild pollFds from pollEntries
+    // Rebuild pollFds from pollEntries (pollIds keeps the id for each slot)
     pollFds.clear();
+    pollIds.clear();
 
-    // Add notification pipe as first fd (if available)
-    if (hasNotificationPipe()) {
+    // Add notification eventfd as first fd (if available)
+    if (hasNotificationEventFd()) {
       pollfd notification_pfd;
-      notification_pfd.fd = notification_pipe[0];
+      notification_pfd.fd = notification_event_fd;
       notification_pfd.events = POLLIN;
       notification_pfd.revents = 0;
       pollFds.push_back(notification_pfd);
+      pollIds.push_back(0);
     }
 
-    for (const auto &pair : pollEntries) {
-      const auto &id = pair.first;
-      const auto &entry = pair.second;
+    pollEntries.forEach([this](PollableID id, PollEntry &entry) {
       pollfd pfd;
       pfd.fd = entry.pollable->file_descriptor;
       pfd.events = entry.events;
       pfd.revents = 0;
       pollFds.push_back(pfd);
-    }
+      pollIds.push_back(id);
+    });
 
-    int result = poll(pollFds.data(), pollFds.size(), current_poll_timeout_ms);
+    int result = poll(pollFds.data(), pollFds.size(),
+                      busyPollTimeout(current_poll_timeout_ms));
 
     if (result < 0) {
       if (errno == EINTR)
@@ -128,91 +566,518 @@ void Poller::start() {
       break;
     }
 
+    busyPollRecord(result);
+
     if (result == 0) {
       // Timeout occurred - timers will be processed at the start of next loop
       continue;
     }
 
+    metrics.countWakeup();
+    auto dispatch_start = SteadyClock::now();
+
     // Process events
     size_t index = 0;
 
-    // Check notification pipe first (index 0) if it exists
-    bool has_notification_pipe = hasNotificationPipe();
-    if (has_notification_pipe && pollFds.size() > 0 &&
+    // Check notification eventfd first (index 0) if it exists
+    bool has_notification_fd = hasNotificationEventFd();
+    if (has_notification_fd && pollFds.size() > 0 &&
         pollFds[0].revents & POLLIN) {
-      drainNotificationPipe();
+      drainNotificationEventFd();
     }
 
     processCleanupTasks();
 
-    // Process pollable events (starting after notification pipe if it exists)
-    index = has_notification_pipe ? 1 : 0;
-    for (const auto &pair : pollEntries) {
-      const auto &id = pair.first;
-      const auto &entry = pair.second;
-      if (index >= pollFds.size())
-        break;
-
+    // Process pollable events (starting after notification eventfd if it
+    // exists)
+    // - look each entry up by id because a callback may remove other pollables
+    // while we iterate
+    index = has_notification_fd ? 1 : 0;
+    for (; index < pollFds.size(); index++) {
       short revents = pollFds[index].revents;
-      if (revents != 0) {
-
-        entry.pollable->onEvent(revents);
-        std::string type_str;
-        switch (entry.pollable->type) {
-        case PollableType::SOCKET:
-          type_str = "SOCKET";
-          break;
-        case PollableType::LISTENER:
-          type_str = "LISTENER";
-          break;
-        default:
-          type_str = "UNKNOWN";
-          break;
-        }
-        // std::cout << "Event: " << revents << " for " << type_str <<
-        // std::endl;
-
-        // If this was a POLLOUT event and write buffer is now empty, disable
-        // POLLOUT
-        if (revents & POLLOUT && entry.pollable->type == PollableType::SOCKET) {
-          Socket *socket = static_cast<Socket *>(entry.pollable);
-          if (socket->write_buffer.size() == 0) {
+      if (revents == 0) {
+        continue;
+      }
+
+      PollEntry *entry = pollEntries.find(pollIds[index]);
+      if (!entry) {
+        continue; // Removed by an earlier callback this iteration
+      }
+
+      metrics.countEvents(1);
+      entry->pollable->onEvent(revents);
+
+      // If this was a POLLOUT event and write buffer is now empty, disable
+      // POLLOUT (entry may have been removed by the callback, so re-find it)
+      if (revents & POLLOUT) {
+        entry = pollEntries.find(pollIds[index]);
+        if (entry && entry->pollable->type == PollableType::SOCKET) {
+          Socket *socket = static_cast<Socket *>(entry->pollable);
+          if (!socket->wantsPollout()) {
             // Remove POLLOUT from events to prevent busy loop
-            const_cast<PollEntry &>(entry).events &= ~POLLOUT;
+            entry->events &= ~POLLOUT;
           }
         }
       }
-      index++;
     }
+
+    // Coalesced flush: everything the dispatched handlers wrote goes out now
+    processPendingFlushes();
+
+    metrics.dispatch_latency.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            SteadyClock::now() - dispatch_start)
+            .count());
   }
 }
 
+void Poller::runEpollLoop() {
+  if (!createEpollInstance()) {
+    LOG_ERROR("Failed to create epoll instance: ", strerror(errno));
+    return;
+  }
+
+  // Register the notification eventfd once
+  if (hasNotificationEventFd()) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u32 = kEpollEventFdData;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, notification_event_fd, &ev);
+  }
+
+  while (running) {
+    // Run tasks posted from other threads first
+    drainPostedTasks();
+
+    // Process any expired timers
+    processExpiredTimers();
+
+    // Flush writes queued by posted tasks and timer callbacks before waiting
+    processPendingFlushes();
+
+    // Register pollables whose fds have become valid since last iteration
+    epollRegisterPending();
+
+    // Apply pending POLLOUT requests as EPOLL_CTL_MOD on the affected fds
+    epollApplyPolloutPending();
+
+    // Calculate timeout based on next timer expiry
+    current_poll_timeout_ms = calculatePollTimeout();
+
+    // Size the event buffer to the number of registered fds (+1 for the
+    // notification pipe); the kernel only fills in ready entries
+    epoll_events.resize(pollEntries.size() + 1);
+
+    int result = epoll_wait(epoll_fd, epoll_events.data(), epoll_events.size(),
+                            busyPollTimeout(current_poll_timeout_ms));
+
+    if (result < 0) {
+      if (errno == EINTR)
+        continue; // Interrupted by signal, continue
+      LOG_ERROR("Epoll error: ", strerror(errno));
+      break;
+    }
+
+    busyPollRecord(result);
+
+    if (result == 0) {
+      // Timeout occurred - timers will be processed at the start of next loop
+      continue;
+    }
+
+    metrics.countWakeup();
+    auto dispatch_start = SteadyClock::now();
+
+    // Drain the notification eventfd first if it fired
+    for (int i = 0; i < result; ++i) {
+      if (epoll_events[i].data.u32 == kEpollEventFdData) {
+        drainNotificationEventFd();
+      }
+    }
+
+    processCleanupTasks();
+
+    // Process pollable events - look each entry up by id because a callback
+    // may remove other pollables while we iterate
+    for (int i = 0; i < result; ++i) {
+      if (epoll_events[i].data.u32 == kEpollEventFdData) {
+        continue;
+      }
+
+      PollableID id = epoll_events[i].data.u32;
+      PollEntry *entry = pollEntries.find(id);
+      if (!entry) {
+        continue; // Removed by an earlier callback this iteration
+      }
+
+      short revents = fromEpollEvents(epoll_events[i].events);
+      metrics.countEvents(1);
+      entry->pollable->onEvent(revents);
+
+      // If this was a POLLOUT event and write buffer is now empty, disable
+      // POLLOUT to prevent a busy loop (entry may have been removed by the
+      // callback, so re-find it)
+      if (revents & POLLOUT) {
+        entry = pollEntries.find(id);
+        if (entry && entry->pollable->type == PollableType::SOCKET &&
+            entry->pollable->file_descriptor >= 0) {
+          Socket *socket = static_cast<Socket *>(entry->pollable);
+          if (!socket->wantsPollout() && (entry->events & POLLOUT)) {
+            entry->events &= ~POLLOUT;
+            epollUpdateEntry(id, *entry, EPOLL_CTL_MOD);
+          }
+        }
+      }
+    }
+
+    // Coalesced flush: everything the dispatched handlers wrote goes out now
+    processPendingFlushes();
+
+    metrics.dispatch_latency.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            SteadyClock::now() - dispatch_start)
+            .count());
+  }
+}
+
+#if WEB_SERVER_HAS_IO_URING
+
+void Poller::runIoUringLoop() {
+  // The loop relies on EXT_ARG (kernel 5.11+) to bound the wait by the next
+  // timer expiry; without it - or without io_uring at all - use epoll instead
+  if (!uring.init(4096) || !uring.ext_arg_supported) {
+    LOG_ERROR("io_uring unavailable, falling back to epoll backend");
+    uring.shutdown();
+    runEpollLoop();
+    return;
+  }
+
+  bool event_fd_armed = false;
+
+  while (running) {
+    // Run tasks posted from other threads first
+    drainPostedTasks();
+
+    // Process any expired timers
+    processExpiredTimers();
+
+    // Flush writes queued by posted tasks and timer callbacks before waiting
+    processPendingFlushes();
+
+    // Batch all POLL_ADD (re)arms for this iteration into the SQ ring
+    uringArmPending();
+
+    // Apply pending POLLOUT requests (cancel + rearm with the new event mask)
+    uringApplyPolloutPending();
+
+    if (hasNotificationEventFd() && !event_fd_armed) {
+      auto *sqe = uring.getSqe();
+      if (sqe) {
+        IoUring::preparePollAdd(sqe, notification_event_fd, POLLIN,
+                                kUringEventFdData);
+        event_fd_armed = true;
+      }
+    }
+
+    // Calculate timeout based on next timer expiry
+    current_poll_timeout_ms = calculatePollTimeout();
+
+    // One syscall submits every queued SQE and waits for completions
+    int result =
+        uring.submitAndWait(1, busyPollTimeout(current_poll_timeout_ms));
+
+    if (result < 0) {
+      if (errno == EINTR || errno == ETIME) {
+        busyPollRecord(0);
+        continue; // Signal or timeout - timers run at the top of the loop
+      }
+      LOG_ERROR("io_uring_enter error: ", strerror(errno));
+      break;
+    }
+
+    processCleanupTasks();
+
+    metrics.countWakeup();
+    auto dispatch_start = SteadyClock::now();
+
+    // Bulk-consume completions from the shared CQ ring (no syscalls here)
+    int completions = 0;
+    struct io_uring_cqe *cqe = nullptr;
+    while (uring.peekCqe(&cqe)) {
+      completions++;
+      uint64_t user_data = cqe->user_data;
+      int res = cqe->res;
+      uring.advanceCqe();
+
+      if (user_data == kUringEventFdData) {
+        drainNotificationEventFd();
+        event_fd_armed = false;
+        continue;
+      }
+      if (user_data == kUringCancelData) {
+        continue; // Completion of a POLL_REMOVE, nothing to do
+      }
+
+      PollableID id = static_cast<PollableID>(user_data);
+      PollEntry *entry = pollEntries.find(id);
+      if (!entry) {
+        continue; // Removed by an earlier callback this iteration
+      }
+
+      // POLL_ADD is one-shot: queue a rearm for the next iteration
+      entry->armed = false;
+      uring_rearm.push_back(id);
+
+      if (res <= 0) {
+        continue; // Cancelled (-ECANCELED) or failed poll
+      }
+
+      short revents = static_cast<short>(res);
+      metrics.countEvents(1);
+      entry->pollable->onEvent(revents);
+
+      // If this was a POLLOUT event and write buffer is now empty, drop
+      // POLLOUT from the mask before the rearm to prevent a busy loop
+      if (revents & POLLOUT) {
+        entry = pollEntries.find(id);
+        if (entry && entry->pollable->type == PollableType::SOCKET) {
+          Socket *socket = static_cast<Socket *>(entry->pollable);
+          if (!socket->wantsPollout()) {
+            entry->events &= ~POLLOUT;
+          }
+        }
+      }
+    }
+
+    // Coalesced flush: everything the dispatched handlers wrote goes out now
+    processPendingFlushes();
+
+    if (completions > 0) {
+      metrics.dispatch_latency.record(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              SteadyClock::now() - dispatch_start)
+              .count());
+    }
+
+    busyPollRecord(completions);
+  }
+
+  uring.shutdown();
+}
+
+void Poller::uringArmPending() {
+  // Move newly created pollables whose fd has become valid into the rearm list
+  auto pending_it = epoll_pending_registration.begin();
+  while (pending_it != epoll_pending_registration.end()) {
+    PollEntry *entry = pollEntries.find(*pending_it);
+    if (!entry) {
+      pending_it = epoll_pending_registration.erase(pending_it);
+      continue;
+    }
+    if (entry->pollable->file_descriptor < 0) {
+      ++pending_it; // fd not known yet, retry next iteration
+      continue;
+    }
+    uring_rearm.push_back(*pending_it);
+    pending_it = epoll_pending_registration.erase(pending_it);
+  }
+
+  // Prepare one POLL_ADD per entry; all of them go out in a single enter()
+  size_t consumed = 0;
+  for (; consumed < uring_rearm.size(); ++consumed) {
+    PollEntry *entry = pollEntries.find(uring_rearm[consumed]);
+    if (!entry) {
+      continue;
+    }
+
+    if (entry->armed || entry->pollable->file_descriptor < 0) {
+      continue;
+    }
+
+    auto *sqe = uring.getSqe();
+    if (!sqe) {
+      break; // SQ ring full - the rest retry next iteration
+    }
+
+    IoUring::preparePollAdd(sqe, entry->pollable->file_descriptor,
+                            entry->events, uring_rearm[consumed]);
+    entry->armed = true;
+  }
+  uring_rearm.erase(uring_rearm.begin(), uring_rearm.begin() + consumed);
+}
+
+void Poller::uringApplyPolloutPending() {
+  for (auto &pending : pollout_pending) {
+    auto socket_id = pending.first;
+    if (!pending.second) {
+      continue;
+    }
+
+    PollEntry *poll_entry = pollEntries.find(socket_id);
+    if (!poll_entry) {
+      pending.second = false;
+      continue;
+    }
+
+    PollEntry &entry = *poll_entry;
+    if (!(entry.events & POLLOUT)) {
+      entry.events |= POLLOUT;
+      if (entry.armed) {
+        // Cancel the outstanding POLL_ADD; the cancellation completion queues
+        // a rearm which then picks up the widened event mask
+        auto *sqe = uring.getSqe();
+        if (sqe) {
+          IoUring::preparePollRemove(sqe, socket_id, kUringCancelData);
+        }
+      } else {
+        uring_rearm.push_back(socket_id);
+      }
+    }
+    pending.second = false;
+  }
+}
+
+#else
+
+void Poller::runIoUringLoop() {
+  LOG_ERROR("io_uring support not compiled in, falling back to epoll backend");
+  runEpollLoop();
+}
+
+#endif // WEB_SERVER_HAS_IO_URING
+
+bool Poller::createEpollInstance() {
+  if (epoll_fd != -1) {
+    return true; // Already created
+  }
+  epoll_fd = epoll_create1(0);
+  return epoll_fd != -1;
+}
+
+void Poller::closeEpollInstance() {
+  if (epoll_fd != -1) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+}
+
+void Poller::epollRegisterPending() {
+  if (epoll_pending_registration.empty()) {
+    return;
+  }
+
+  // Register every pending pollable that has a valid fd by now; the rest stay
+  // queued until their fd is assigned
+  auto it = epoll_pending_registration.begin();
+  while (it != epoll_pending_registration.end()) {
+    PollEntry *entry = pollEntries.find(*it);
+    if (!entry) {
+      it = epoll_pending_registration.erase(it);
+      continue;
+    }
+
+    if (entry->pollable->file_descriptor < 0) {
+      ++it; // fd not known yet, retry next iteration
+      continue;
+    }
+
+    epollUpdateEntry(*it, *entry, EPOLL_CTL_ADD);
+    it = epoll_pending_registration.erase(it);
+  }
+}
+
+void Poller::epollApplyPolloutPending() {
+  for (auto &entry : pollout_pending) {
+    auto socket_id = entry.first;
+    auto &pending = entry.second;
+    if (pending) {
+      PollEntry *poll_entry = pollEntries.find(socket_id);
+      if (poll_entry) {
+        if (poll_entry->pollable->file_descriptor < 0) {
+          continue; // fd not known yet - stays pending until registered
+        }
+        if (!(poll_entry->events & POLLOUT)) {
+          poll_entry->events |= POLLOUT;
+          // Not yet registered? The ADD below picks the mask up instead
+          if (std::find(epoll_pending_registration.begin(),
+                        epoll_pending_registration.end(),
+                        socket_id) == epoll_pending_registration.end()) {
+            epollUpdateEntry(socket_id, *poll_entry, EPOLL_CTL_MOD);
+          }
+        }
+        pending = false;
+      }
+    }
+  }
+}
+
+void Poller::epollUpdateEntry(PollableID id, const PollEntry &entry, int op) {
+  struct epoll_event ev = {};
+  ev.events = toEpollEvents(entry.events);
+  ev.data.u32 = id;
+
+  if (epoll_ctl(epoll_fd, op, entry.pollable->file_descriptor, &ev) == -1) {
+    LOG_ERROR("epoll_ctl failed for fd ", entry.pollable->file_descriptor, ": ",
+              strerror(errno));
+  }
+}
+
+uint32_t Poller::toEpollEvents(short events) const {
+  uint32_t epoll_ev = 0;
+  if (events & POLLIN)
+    epoll_ev |= EPOLLIN;
+  if (events & POLLOUT)
+    epoll_ev |= EPOLLOUT;
+  if (backend == PollerBackend::EPOLL_EDGE_TRIGGERED)
+    epoll_ev |= EPOLLET;
+  return epoll_ev;
+}
+
+short Poller::fromEpollEvents(uint32_t events) const {
+  short poll_ev = 0;
+  if (events & EPOLLIN)
+    poll_ev |= POLLIN;
+  if (events & EPOLLOUT)
+    poll_ev |= POLLOUT;
+  if (events & EPOLLERR)
+    poll_ev |= POLLERR;
+  if (events & EPOLLHUP)
+    poll_ev |= POLLHUP;
+  return poll_ev;
+}
+
 void Poller::stop() {
   running = false;
   // Stop executor first
   executor.stop();
 
-  for (auto &pair : pollEntries) {
-    auto &id = pair.first;
-    auto &entry = pair.second;
-    entry.pollable->stopFunction();
-  }
+  pollEntries.forEach(
+      [](PollableID id, PollEntry &entry) { entry.pollable->stopFunction(); });
+
+  // Close notification eventfd
+  closeNotificationEventFd();
 
-  // Close notification pipe
-  closeNotificationPipe();
+  // Close epoll instance (no-op for the POLL backend)
+  closeEpollInstance();
 }
 
 // Timer implementation
-Poller::TimerID Poller::setTimeout(uint32_t ms, TimerCallback callback) {
+Poller::TimerID Poller::setTimeout(uint32_t ms, TimerCallback callback,
+                                   TimerPolicy policy) {
   TimerID id = next_timer_id++;
-  auto now = SteadyClock::now();
-  auto expiry = SteadyClock::addMilliseconds(now, ms);
+  TimerWheel::Tick expiry_tick = nowTick() + ms;
 
   timers[id] = TimerEntry{
-      id,    expiry, ms, callback,
+      id,    expiry_tick, ms, std::move(callback),
       false, // not an interval
-      true   // active
-  };
+      true,  // active
+      policy};
+  timer_wheel.insert(id, expiry_tick);
+
+  // Lazy-start the worker pool the same way connectAsync does
+  if (policy == TimerPolicy::OFFLOAD && !executor.isRunning()) {
+    executor.start();
+  }
 
   // If poller is running, notify to recalculate timeout
   // (especially important when called from within timer callbacks)
@@ -223,16 +1088,21 @@ Poller::TimerID Poller::setTimeout(uint32_t ms, TimerCallback callback) {
   return id;
 }
 
-Poller::TimerID Poller::setInterval(uint32_t ms, TimerCallback callback) {
+Poller::TimerID Poller::setInterval(uint32_t ms, TimerCallback callback,
+                                    TimerPolicy policy) {
   TimerID id = next_timer_id++;
-  auto now = SteadyClock::now();
-  auto expiry = SteadyClock::addMilliseconds(now, ms);
+  TimerWheel::Tick expiry_tick = nowTick() + ms;
 
   timers[id] = TimerEntry{
-      id,   expiry, ms, callback,
+      id,   expiry_tick, ms, std::move(callback),
       true, // is an interval
-      true  // active
-  };
+      true, // active
+      policy};
+  timer_wheel.insert(id, expiry_tick);
+
+  if (policy == TimerPolicy::OFFLOAD && !executor.isRunning()) {
+    executor.start();
+  }
 
   // If new timer has smaller timeout than current poll timeout, notify to
   // recalculate
@@ -268,114 +1138,127 @@ void Poller::processCleanupTasks() {
   cleanupTasks.clear();
 }
 
+TimerWheel::Tick Poller::nowTick() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             SteadyClock::now() - wheel_origin)
+      .count();
+}
+
 int Poller::calculatePollTimeout() {
   if (timers.empty()) {
     return max_poll_timeout_ms;
   }
 
-  auto now = SteadyClock::now();
-  auto next_expiry = SteadyClock::TimePoint::max();
-
-  // Find the earliest timer expiry
-  for (const auto &pair : timers) {
-    const auto &id = pair.first;
-    const auto &timer = pair.second;
-    if (timer.active && timer.expiry_time < next_expiry) {
-      next_expiry = timer.expiry_time;
-    }
-  }
-
-  if (next_expiry == SteadyClock::TimePoint::max()) {
-    return max_poll_timeout_ms; // No active timers, use default timeout
-  }
-
-  // Calculate milliseconds until next expiry
-  int timeout_ms = SteadyClock::durationMs(now, next_expiry);
-
-  // Ensure we don't return negative timeout or wait too long
+  // The wheel knows where the next due slot is - no full timer scan needed
+  int timeout_ms = timer_wheel.msUntilNext(max_poll_timeout_ms);
   return std::max(1, std::min(timeout_ms, max_poll_timeout_ms));
 }
 
 void Poller::processExpiredTimers() {
-  auto now = SteadyClock::now();
-  std::vector<TimerID> expired_timers;
-
-  // Find expired timers
-  for (auto &pair : timers) {
-    const auto &id = pair.first;
-    auto &timer = pair.second;
-    if (timer.active && timer.expiry_time <= now) {
-      expired_timers.push_back(id);
-    }
-  }
+  TimerWheel::Tick now_tick = nowTick();
 
-  // Process expired timers
-  for (TimerID id : expired_timers) {
+  // Bulk-expiry: one pass over the due wheel slots fires every due timer
+  timer_wheel.advance(now_tick, [this, now_tick](TimerID id,
+                                                 TimerWheel::Tick expiry) {
     auto it = timers.find(id);
-    if (it != timers.end()) {
-      TimerEntry &timer = it->second;
+    if (it == timers.end() || it->second.expiry_tick != expiry) {
+      return; // Cancelled (lazy removal) or rescheduled since insertion
+    }
 
-      // Execute callback
-      timer.callback();
+    metrics.countTimerFire();
 
-      if (timer.is_interval) {
-        // Reschedule interval timer
-        timer.expiry_time = SteadyClock::addMilliseconds(now, timer.interval_ms);
-      } else {
-        // Remove one-time timer
+    if (it->second.policy == TimerPolicy::OFFLOAD) {
+      // Dispatch to the Executor so a slow job can't stall the poll loop.
+      // The callback is moved into a shared_ptr: InplaceFunction is
+      // move-only, and a 64-byte one nested inside another would overflow
+      // the Task's inline capacity anyway.
+      auto callback =
+          std::make_shared<TimerCallback>(std::move(it->second.callback));
+      if (!it->second.is_interval) {
         timers.erase(it);
+        executor.submit([callback]() { (*callback)(); });
+        return;
       }
+      // Interval: deliberately NOT re-inserted into the wheel here. The
+      // next expiry is armed only after the run completes (marshalled back
+      // via post, which also returns the moved-out callback to the entry),
+      // so a job slower than its period runs back-to-back instead of
+      // piling up behind itself.
+      executor.submit([this, id, callback]() {
+        (*callback)();
+        post([this, id, callback]() {
+          rearmOffloadedInterval(id, std::move(*callback));
+        });
+      });
+      return;
     }
-  }
-}
 
-// Pipe helper methods
-bool Poller::createNotificationPipe() {
-  if (notification_pipe[0] == -1 && notification_pipe[1] == -1) {
-    if (pipe(notification_pipe) == -1) {
-      notification_pipe[0] = -1;
-      notification_pipe[1] = -1;
-      return false;
+    // Execute callback (it may add/cancel timers, invalidating iterators)
+    it->second.callback();
+
+    auto post_it = timers.find(id);
+    if (post_it == timers.end()) {
+      return;
     }
 
-    // Make the read end non-blocking
-    int flags = fcntl(notification_pipe[0], F_GETFL, 0);
-    if (flags != -1) {
-      fcntl(notification_pipe[0], F_SETFL, flags | O_NONBLOCK);
+    if (post_it->second.is_interval) {
+      // Reschedule interval timer
+      post_it->second.expiry_tick = now_tick + post_it->second.interval_ms;
+      timer_wheel.insert(id, post_it->second.expiry_tick);
+    } else {
+      // Remove one-time timer
+      timers.erase(post_it);
     }
+  });
+}
 
-    return true;
+void Poller::rearmOffloadedInterval(TimerID id, TimerCallback callback) {
+  // Runs on the poller thread once an OFFLOADed interval's run finished.
+  // clearInterval may have erased the entry while the run was in flight -
+  // then there is simply nothing to re-arm.
+  auto it = timers.find(id);
+  if (it == timers.end() || !it->second.active) {
+    return;
+  }
+  it->second.callback = std::move(callback);
+  it->second.expiry_tick = nowTick() + it->second.interval_ms;
+  timer_wheel.insert(id, it->second.expiry_tick);
+  if (running && (int)it->second.interval_ms < current_poll_timeout_ms) {
+    notify();
   }
-  return true; // Already created
 }
 
-void Poller::closeNotificationPipe() {
-  if (notification_pipe[0] != -1) {
-    close(notification_pipe[0]);
-    notification_pipe[0] = -1;
-  }
-  if (notification_pipe[1] != -1) {
-    close(notification_pipe[1]);
-    notification_pipe[1] = -1;
+// Notification eventfd helper methods
+bool Poller::createNotificationEventFd() {
+  if (notification_event_fd == -1) {
+    notification_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return notification_event_fd != -1;
   }
+  return true; // Already created
 }
 
-bool Poller::hasNotificationPipe() const { return notification_pipe[0] != -1; }
+void Poller::closeNotificationEventFd() {
+  if (notification_event_fd != -1) {
+    close(notification_event_fd);
+    notification_event_fd = -1;
+  }
+}
 
-void Poller::drainNotificationPipe() {
-  if (hasNotificationPipe()) {
-    char buffer[256];
-    ssize_t bytes_read;
+bool Poller::hasNotificationEventFd() const {
+  return notification_event_fd != -1;
+}
 
-    while ((bytes_read = read(notification_pipe[0], buffer, sizeof(buffer))) >
-           0) {
-      // Just drain the pipe, no action needed
-    }
+void Poller::drainNotificationEventFd() {
+  if (hasNotificationEventFd()) {
+    // One read resets the coalesced counter, no matter how many writers
+    // bumped it since the last wakeup
+    uint64_t count = 0;
+    ssize_t bytes_read =
+        read(notification_event_fd, &count, sizeof(count));
 
-    // Check if we stopped because of EAGAIN/EWOULDBLOCK (normal for
-    // non-blocking) or because of an actual error
+    // EAGAIN just means another drain already consumed the counter
     if (bytes_read == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
-      LOG_ERROR("Error draining notification pipe: ", strerror(errno));
+      LOG_ERROR("Error draining notification eventfd: ", strerror(errno));
     }
   }
 }
\ No newline at end of file
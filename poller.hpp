@@ -1,42 +1,128 @@
 #pragma once
 #include "executor.hpp"
+#include "io_uring.hpp"
 #include "listener.hpp"
+#include "metrics.hpp"
+#include "mpsc_queue.hpp"
 #include "pollable.hpp"
 #include "pollable_pool_manager.hpp"
 #include "socket.hpp"
 #include "steady_clock.hpp"
+#include "timer_wheel.hpp"
 #include <chrono>
+#include <cstdio> // snprintf in renderPrometheus
 #include <errno.h>
 #include <functional>
 #include <map>
 #include <poll.h>
+#include <unordered_map>
 #include <signal.h> // For sigaction and siginfo_t
 #include <stdexcept>
+#include <sys/epoll.h>
 #include <thread>
 #include <unistd.h> // For pipe() and close()
 #include <vector>
 
+// Event loop backend selection:
+// - POLL rebuilds the pollfd array from pollEntries on every iteration and
+//   lets the kernel scan all fds (O(n) per wakeup).
+// - EPOLL registers each fd once and only pays for fds that actually have
+//   events (level-triggered, same wakeup semantics as poll).
+// - EPOLL_EDGE_TRIGGERED is like EPOLL but only reports state *changes*;
+//   handlers must drain reads/writes until EAGAIN before waiting again.
+// - IO_URING batches all readiness (re)arms of a loop iteration into a single
+//   io_uring_enter() syscall and consumes completions in bulk from the shared
+//   completion ring. Falls back to EPOLL when io_uring is unavailable.
+enum class PollerBackend { POLL, EPOLL, EPOLL_EDGE_TRIGGERED, IO_URING };
+
 struct Poller {
   struct PollEntry {
     Pollable *pollable = nullptr;
-    short events = 0; // poll events (POLLIN, POLLOUT, etc.)
+    short events = 0;   // poll events (POLLIN, POLLOUT, etc.)
+    bool armed = false; // io_uring: an outstanding POLL_ADD exists for this fd
+  };
+
+  // Dense slot table for poll entries, addressed directly by the slot bits of
+  // the PollableID: O(1) find/insert/erase, generation-checked against stale
+  // IDs, and linear (cache-friendly) iteration during event dispatch
+  struct PollEntryTable {
+    std::vector<PollEntry> entries = {};
+    std::vector<PollableID> ids = {};
+    size_t count = 0;
+
+    PollEntry *find(PollableID id) {
+      uint32_t slot = pollableSlotKey(id);
+      if (slot >= entries.size() || ids[slot] != id ||
+          entries[slot].pollable == nullptr) {
+        return nullptr;
+      }
+      return &entries[slot];
+    }
+
+    void insert(PollableID id, const PollEntry &entry) {
+      uint32_t slot = pollableSlotKey(id);
+      if (slot >= entries.size()) {
+        entries.resize(slot + 1);
+        ids.resize(slot + 1, 0);
+      }
+      if (entries[slot].pollable == nullptr) {
+        count++;
+      }
+      entries[slot] = entry;
+      ids[slot] = id;
+    }
+
+    void erase(PollableID id) {
+      PollEntry *entry = find(id);
+      if (entry) {
+        entry->pollable = nullptr;
+        count--;
+      }
+    }
+
+    size_t size() const { return count; }
+
+    // Iterate occupied slots; safe against erase() of the visited entry but
+    // not against inserts that grow the table mid-iteration
+    template <typename Fn> void forEach(Fn &&fn) {
+      for (size_t slot = 0; slot < entries.size(); ++slot) {
+        if (entries[slot].pollable != nullptr) {
+          fn(ids[slot], entries[slot]);
+        }
+      }
+    }
   };
 
   // Timer structures for poll-based timing
   using TimerID = uint32_t;
-  using TimerCallback = std::function<void()>;
+  using TimerCallback = InplaceFunction<void()>;
+  using Task = ::Task; // executor.hpp's InplaceFunction<void()>
+
+  // Where a timer callback runs: INLINE on the poller thread (today's
+  // behavior, the default), or OFFLOAD on the Executor so a slow periodic
+  // job can't stall I/O dispatch. An OFFLOADed interval is not re-armed
+  // until the previous run completes - a job slower than its period
+  // degrades to back-to-back runs instead of piling up. OFFLOAD callbacks
+  // run off-thread: touch pollables or poller state only through post().
+  enum class TimerPolicy { INLINE, OFFLOAD };
 
   struct TimerEntry {
     TimerID id;
-    SteadyClock::TimePoint expiry_time;
+    TimerWheel::Tick expiry_tick; // ms since wheel_origin
     uint32_t interval_ms;
     TimerCallback callback;
     bool is_interval;
     bool active;
+    TimerPolicy policy = TimerPolicy::INLINE;
   };
 
   TimerID next_timer_id = 1;
-  std::map<TimerID, TimerEntry> timers;
+
+  // Timer state lives here; due-time ordering lives in the timer wheel so
+  // insert/cancel/expiry stay O(1) even with tens of thousands of intervals
+  std::unordered_map<TimerID, TimerEntry> timers;
+  TimerWheel timer_wheel = {};
+  SteadyClock::TimePoint wheel_origin = SteadyClock::now();
 
   // Maximum timeout for poll() calls (in milliseconds, -1 means no limit)
   int max_poll_timeout_ms = 1000;
@@ -44,35 +130,117 @@ struct Poller {
   // Current poll timeout being used (for optimization)
   int current_poll_timeout_ms = 1000;
 
+  // Adaptive busy-poll (latency mode, off by default): after
+  // busy_poll_streak consecutive waits that delivered events, the loop
+  // switches to zero-timeout waits and spins through a busy_poll_window_us
+  // budget of idle spinning before parking in the kernel again. Every busy
+  // wakeup refills the budget; busy_poll_decay > 1 drains it that much
+  // faster while idle. Trades a bounded amount of CPU for not paying the
+  // kernel sleep/wake cost between closely spaced events.
+  bool busy_poll_enabled = false;
+  int busy_poll_streak = 3;
+  int busy_poll_window_us = 200;
+  int busy_poll_decay = 1;
+
   PollablePoolManager poolManager = PollablePoolManager{};
   std::vector<pollfd> pollFds = {};
-  std::map<PollableID, PollEntry> pollEntries = {};
+  std::vector<PollableID> pollIds = {}; // id per pollFds entry (same order)
+  PollEntryTable pollEntries = {};
   bool running = false;
 
+  // Backend selection (EPOLL by default - avoids the per-iteration pollFds
+  // rebuild and kernel-side fd scanning that dominates with many connections)
+  PollerBackend backend = PollerBackend::EPOLL;
+
+  // epoll state (only used by the EPOLL backends)
+  int epoll_fd = -1;
+  std::vector<struct epoll_event> epoll_events = {};
+
+  // Pollables created before their fd is known (e.g. createSocket() before
+  // accept() assigns the fd) - registered with epoll once the fd shows up
+  std::vector<PollableID> epoll_pending_registration = {};
+
+#if WEB_SERVER_HAS_IO_URING
+  // io_uring state (only used by the IO_URING backend)
+  IoUring uring = {};
+
+  // Pollables whose one-shot POLL_ADD completed and need re-arming
+  std::vector<PollableID> uring_rearm = {};
+#endif
+
   // Tracking of sockets that need POLLOUT enabled
   std::map<PollableID, bool> pollout_pending = {};
 
-  std::vector<std::function<void()>> cleanupTasks = {};
+  // Sockets that queued bytes this iteration, flushed once per loop by
+  // processPendingFlushes (write coalescing: several write() calls from one
+  // handler become a single writev). Only sockets the kernel pushed back on
+  // fall through to the POLLOUT machinery above.
+  std::vector<PollableID> flush_pending = {};
+
+  std::vector<Task> cleanupTasks = {};
+
+  // Tasks posted from other threads, drained at the top of the event loop
+  MpscQueue<Task> posted_tasks = {};
 
   // Executor for handling callbacks in separate threads
   Executor executor{};
 
-  // Notification pipe for breaking poll() calls
-  int notification_pipe[2] = {-1, -1};
+  // Hot-path counters, single writer (this poller's thread); scraped via
+  // MetricsRegistry / HttpServer::enableMetrics()
+  PollerMetrics metrics = {};
+
+  // Resource governor (off by default, see enableGovernor): self-protection
+  // under overload so compliant clients keep a flat p99 while an incident
+  // is in progress. Three independent caps:
+  //  - max_connections: inbound connections over the cap are shed straight
+  //    off the accept loop (LIFO - the newest connection pays), answered
+  //    with a preserialized 503 (or silently closed when shed_with_503 is
+  //    off) before any pool slot or parsing is spent on them.
+  //  - accept_rate: a token bucket (one second of burst) meters accepts;
+  //    when it runs dry the listener's POLLIN is paused until the bucket
+  //    refills, so the backlog absorbs the storm instead of the loop.
+  //  - write_buffer_cap: a periodic sweep evicts sockets whose queued
+  //    bytes stay over the cap for longer than the grace period - slow
+  //    readers stop holding buffer memory and poll-set space hostage.
+  bool governor_enabled = false;
+  size_t governor_max_connections = 0;  // 0 = unlimited
+  size_t governor_write_buffer_cap = 0; // bytes queued per socket, 0 = off
+  uint32_t governor_write_cap_grace_ms = 1000;
+  uint32_t governor_accept_rate = 0; // accepts/second, 0 = unlimited
+  bool governor_shed_with_503 = true;
+  uint32_t governor_sweep_interval_ms = 100;
+  TimerID governor_timer = 0; // sweep interval, 0 while not enabled
+  double governor_accept_tokens = 0;
+  SteadyClock::TimePoint governor_token_refill = {};
+  size_t socket_count = 0; // live sockets (maintained by create/remove)
+
+  // eventfd for breaking poll() calls; the kernel coalesces writes into one
+  // counter, so any number of notify()/post() calls cost at most one wakeup
+  int notification_event_fd = -1;
 
   // Thread ID of the poller thread
   std::thread::id poller_thread_id;
 
   // Constructor - initialize executor with default thread count
   Poller(size_t executorThreads = std::thread::hardware_concurrency())
-      : executor(executorThreads) {}
+      : executor(executorThreads) {
+    MetricsRegistry::instance().add(this);
+  }
+
+  // Constructor with explicit backend selection
+  Poller(PollerBackend backend,
+         size_t executorThreads = std::thread::hardware_concurrency())
+      : backend(backend), executor(executorThreads) {
+    MetricsRegistry::instance().add(this);
+  }
 
   // Destructor
-  ~Poller() = default;
+  ~Poller() { MetricsRegistry::instance().remove(this); }
 
   // Factory methods
   Socket *createSocket();
   Listener *createListener();
+  DatagramSocket *createDatagramSocket();
   void removePollable(PollableID id);
 
   void start();
@@ -81,32 +249,229 @@ struct Poller {
   // Method to enable POLLOUT for a socket (thread-safe)
   void enablePollout(PollableID socket_id);
 
+  // Queue a socket for the end-of-iteration flush pass (poller thread only;
+  // Socket::write calls this via requestFlush, which dedupes per socket)
+  void scheduleFlush(PollableID socket_id);
+
+  // Drop / restore POLLIN interest for a pollable - the read-side
+  // backpressure hook (see HttpBodyReader). Poller thread only. Bytes
+  // already read keep flowing through the current dispatch; the pause
+  // takes effect from the next wait.
+  void pauseReads(PollableID socket_id);
+  void resumeReads(PollableID socket_id);
+
+  // Hand a live socket to another poller (shard rebalancing). The fd leaves
+  // this loop's event set without being closed; the socket's buffers,
+  // callbacks, and userData travel through the target's cross-thread post
+  // queue into a fresh slot of its pool, which re-registers the same fd
+  // there - level-triggered readiness then re-reports any bytes the kernel
+  // buffered during the hop, so nothing is dropped. The source PollableID
+  // dies with its slot; on_migrated runs on the target's thread with the
+  // new Socket so protocol owners can re-key per-socket bookkeeping
+  // (WebSocketServer::migrateConnection wraps this for WebSocket
+  // connections). Source poller thread only. Returns false for unknown or
+  // non-socket IDs, closed sockets, and sockets mid-connect; TLS sockets
+  // cannot migrate (their wrapped onEvent owns loop-local TLS state).
+  using MigrateCallback = std::function<void(Socket &)>;
+  bool migrate(PollableID socket_id, Poller &target,
+               MigrateCallback on_migrated = nullptr);
+
   // Notification methods for breaking poll() calls
   void notify(); // Wake up poll() call from another thread
   void
   setMaxPollTimeout(int max_timeout_ms); // Set maximum timeout for poll() calls
 
+  // Enable adaptive busy-polling (see the busy_poll_* members for the knobs)
+  void enableBusyPoll(int window_us, int streak = 3, int decay = 1);
+
+  // Turn the resource governor on (see the governor_* members for the
+  // semantics of each cap; 0 leaves a dimension unlimited) and start the
+  // write-buffer eviction sweep
+  void enableGovernor(size_t max_connections, size_t write_buffer_cap,
+                      uint32_t write_cap_grace_ms = 1000,
+                      uint32_t accept_rate = 0);
+
+  // Accept-loop hooks (called by Listener per inbound connection):
+  // governorShouldAccept meters the accept rate - a false return also
+  // parks the listener's POLLIN until the token bucket refills;
+  // governorAdmit checks the connection cap - false means shed this fd
+  bool governorShouldAccept(PollableID listener_id);
+  bool governorAdmit() {
+    return !governor_enabled || governor_max_connections == 0 ||
+           socket_count < governor_max_connections;
+  }
+  // The accept that a token was charged for hit an empty backlog - put it
+  // back so bookkeeping wakeups don't eat into the configured rate
+  void governorRefundAccept() {
+    if (governor_enabled && governor_accept_rate > 0) {
+      governor_accept_tokens =
+          std::min(static_cast<double>(governor_accept_rate),
+                   governor_accept_tokens + 1.0);
+    }
+  }
+
+  // Run a task on the poller thread (thread-safe, lock-free). The safe way
+  // for Executor workers to touch pollables/poller state: the task runs at
+  // the top of the next event loop iteration, on the poller thread.
+  void post(Task task);
+
   // Timer methods
-  TimerID setTimeout(uint32_t ms, TimerCallback callback);
-  TimerID setInterval(uint32_t ms, TimerCallback callback);
+  TimerID setTimeout(uint32_t ms, TimerCallback callback,
+                     TimerPolicy policy = TimerPolicy::INLINE);
+  TimerID setInterval(uint32_t ms, TimerCallback callback,
+                      TimerPolicy policy = TimerPolicy::INLINE);
   void clearTimeout(TimerID timer_id);
   void clearInterval(TimerID timer_id);
 
 protected:
   void processCleanupTasks();
 
+  // Flush every socket queued via scheduleFlush, arming kernel POLLOUT only
+  // for the ones whose bytes didn't all fit. Called once after the timer /
+  // posted-task phase and once after event dispatch, so writes made anywhere
+  // in an iteration go out in that same iteration.
+  void processPendingFlushes();
+
   void addPollable(Pollable *pollable);
 
   // Helper method to update poll events safely
   void updatePollEvents();
 
+  // Push an entry's changed event mask down to the active backend (the
+  // POLL backend rebuilds its pollfd array per iteration and needs nothing)
+  void applyEventMaskChange(PollableID id, PollEntry &entry);
+
+  // Backend loops
+  void runPollLoop();
+  void runEpollLoop();
+  void runIoUringLoop();
+
+#if WEB_SERVER_HAS_IO_URING
+  // io_uring helper methods
+  void uringArmPending();
+  void uringApplyPolloutPending();
+#endif
+
+  // epoll helper methods
+  bool createEpollInstance();
+  void closeEpollInstance();
+  void epollRegisterPending();
+  void epollApplyPolloutPending();
+  void epollUpdateEntry(PollableID id, const PollEntry &entry, int op);
+  uint32_t toEpollEvents(short events) const;
+  short fromEpollEvents(uint32_t events) const;
+
+  // Busy-poll state and helpers
+  int busy_poll_hits = 0;          // consecutive waits that delivered events
+  int64_t busy_poll_credit_us = 0; // remaining idle spin budget
+  SteadyClock::TimePoint busy_poll_wait_start;
+
+  int busyPollTimeout(int timeout_ms); // 0 while spin credit remains
+  void busyPollRecord(int result);     // update streak/credit after a wait
+
+  // Evict sockets whose queued bytes have exceeded governor_write_buffer_cap
+  // for longer than the grace period (runs on governor_timer)
+  void governorSweep();
+
   // Timer helper methods
   int calculatePollTimeout();
   void processExpiredTimers();
+  void rearmOffloadedInterval(TimerID id, TimerCallback callback);
+  TimerWheel::Tick nowTick() const;
+
+  void drainPostedTasks();
 
-  // Pipe helper methods
-  bool createNotificationPipe();
-  void closeNotificationPipe();
-  bool hasNotificationPipe() const;
-  void drainNotificationPipe();
+  // Notification eventfd helper methods
+  bool createNotificationEventFd();
+  void closeNotificationEventFd();
+  bool hasNotificationEventFd() const;
+  void drainNotificationEventFd();
 };
+
+// Defined here rather than in metrics.hpp because it reads live Poller
+// state (the metric blocks and each executor's queue depth). Aggregates
+// across every registered poller with relaxed loads - a scrape never stalls
+// the hot path.
+inline std::string MetricsRegistry::renderPrometheus() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  uint64_t wakeups = 0, events = 0, read_bytes = 0, written_bytes = 0;
+  uint64_t timers_fired = 0, posted = 0, executor_pending = 0;
+  uint64_t hist_buckets[LatencyHistogram::BUCKETS] = {};
+  uint64_t hist_sum_us = 0, hist_count = 0;
+
+  for (Poller *poller : pollers) {
+    const PollerMetrics &m = poller->metrics;
+    wakeups += m.poll_wakeups.load(std::memory_order_relaxed);
+    events += m.events_dispatched.load(std::memory_order_relaxed);
+    read_bytes += m.bytes_read.load(std::memory_order_relaxed);
+    written_bytes += m.bytes_written.load(std::memory_order_relaxed);
+    timers_fired += m.timer_fires.load(std::memory_order_relaxed);
+    posted += m.posted_tasks.load(std::memory_order_relaxed);
+    executor_pending += poller->executor.getPendingTaskCount();
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+      hist_buckets[i] +=
+          m.dispatch_latency.buckets[i].load(std::memory_order_relaxed);
+    }
+    hist_sum_us += m.dispatch_latency.sum_us.load(std::memory_order_relaxed);
+    hist_count += m.dispatch_latency.count.load(std::memory_order_relaxed);
+  }
+
+  std::string out;
+  out.reserve(2048);
+  auto counter = [&out](const char *name, const char *help, uint64_t value) {
+    out += "# HELP ";
+    out += name;
+    out += " ";
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += " counter\n";
+    out += name;
+    out += " ";
+    out += std::to_string(value);
+    out += "\n";
+  };
+
+  counter("webserver_poll_wakeups_total",
+          "Event loop wait syscall returns", wakeups);
+  counter("webserver_events_dispatched_total",
+          "Pollable event callbacks dispatched", events);
+  counter("webserver_bytes_read_total", "Payload bytes read from sockets",
+          read_bytes);
+  counter("webserver_bytes_written_total", "Payload bytes written to sockets",
+          written_bytes);
+  counter("webserver_timer_fires_total", "Timer callbacks fired", timers_fired);
+  counter("webserver_posted_tasks_total",
+          "Cross-thread tasks drained by the event loop", posted);
+
+  out += "# HELP webserver_executor_pending_tasks Tasks queued in executors\n"
+         "# TYPE webserver_executor_pending_tasks gauge\n"
+         "webserver_executor_pending_tasks " +
+         std::to_string(executor_pending) + "\n";
+
+  out += "# HELP webserver_dispatch_seconds Time dispatching one wakeup's "
+         "events\n# TYPE webserver_dispatch_seconds histogram\n";
+  uint64_t cumulative = 0;
+  char bound[64];
+  for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+    cumulative += hist_buckets[i];
+    if (i + 1 == LatencyHistogram::BUCKETS) {
+      out += "webserver_dispatch_seconds_bucket{le=\"+Inf\"} ";
+    } else {
+      snprintf(bound, sizeof(bound),
+               "webserver_dispatch_seconds_bucket{le=\"%g\"} ",
+               LatencyHistogram::upperBoundUs(i) / 1e6);
+      out += bound;
+    }
+    out += std::to_string(cumulative);
+    out += "\n";
+  }
+  snprintf(bound, sizeof(bound), "webserver_dispatch_seconds_sum %g\n",
+           hist_sum_us / 1e6);
+  out += bound;
+  out += "webserver_dispatch_seconds_count " + std::to_string(hist_count) +
+         "\n";
+
+  return out;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "poller.hpp"
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// PollerGroup runs one Poller per core so the event loop is no longer bound
+// to a single thread. Each shard owns its pollables; combined with
+// Listener::start(port, /*reuse_port=*/true) every shard accepts its own
+// connections and the kernel load-balances new connections across shards.
+//
+// Typical usage:
+//
+//   PollerGroup group(std::thread::hardware_concurrency());
+//   group.forEach([&](Poller &poller, size_t shard) {
+//     Listener *listener = poller.createListener();
+//     // HttpServer / WebSocketServer are constructed per shard; register the
+//     // same routes on each (handlers are shared, per-shard state is not)
+//     setupServer(poller, listener);
+//     listener->start(8080, /*reuse_port=*/true);
+//   });
+//   group.start(); // blocks until stop()
+struct PollerGroup {
+  std::vector<std::unique_ptr<Poller>> pollers = {};
+  std::vector<std::thread> threads = {};
+  bool running = false;
+
+  PollerGroup(size_t count = std::thread::hardware_concurrency(),
+              PollerBackend backend = PollerBackend::EPOLL) {
+    if (count == 0) {
+      count = 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      // One executor thread per shard - the shards themselves provide the
+      // parallelism, a full executor pool per shard would oversubscribe
+      pollers.push_back(std::make_unique<Poller>(backend, 1));
+    }
+  }
+
+  ~PollerGroup() { stop(); }
+
+  size_t size() const { return pollers.size(); }
+
+  Poller &poller(size_t shard) { return *pollers[shard]; }
+
+  // Run the setup function once per shard (route registration, listeners...)
+  void forEach(const std::function<void(Poller &, size_t)> &setup) {
+    for (size_t i = 0; i < pollers.size(); ++i) {
+      setup(*pollers[i], i);
+    }
+  }
+
+  // Start shards 1..N-1 on their own threads and run shard 0 on the calling
+  // thread, so start() blocks like Poller::start() does
+  void start() {
+    if (running) {
+      return;
+    }
+    running = true;
+
+    for (size_t i = 1; i < pollers.size(); ++i) {
+      Poller *poller = pollers[i].get();
+      threads.emplace_back([poller] { poller->start(); });
+    }
+
+    pollers[0]->start();
+    // Shard 0 returned; stop() joins the remaining shard threads
+  }
+
+  void stop() {
+    if (!running) {
+      return;
+    }
+    running = false;
+
+    // Wake every loop first so no shard stays blocked in its wait call, then
+    // let the loops exit before tearing their state down
+    for (auto &poller : pollers) {
+      poller->running = false;
+      poller->notify();
+    }
+
+    joinThreads();
+
+    for (auto &poller : pollers) {
+      poller->stop();
+    }
+  }
+
+protected:
+  void joinThreads() {
+    for (auto &thread : threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    threads.clear();
+  }
+};
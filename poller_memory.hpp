@@ -250,4 +250,28 @@ void init_poller_memory();
 void cleanup_poller_memory();
 
 // Get current thread's memory areas
-PollerMemoryAreas* get_poller_memory_areas();
\ No newline at end of file
+PollerMemoryAreas* get_poller_memory_areas();
+
+// RAII scope for message-sized work: acquires a frame area, makes it the
+// thread's allocation context for the enclosing block, and resets it on the
+// way out. Containers built under the scope (via the containers.hpp aliases
+// or make_* helpers) bump-allocate from the area and are reclaimed wholesale
+// when it ends - nothing allocated inside may outlive the scope.
+class FrameAreaScope {
+private:
+    AreaAllocatorBase* area;
+    AreaAllocatorContext context;
+
+public:
+    FrameAreaScope()
+        : area(get_poller_memory_areas()->allocate_frame_area())
+        , context(area) {}
+
+    ~FrameAreaScope() { area->reset(); }
+
+    AreaAllocatorBase* get() { return area; }
+
+    // Non-copyable, non-movable (matches AreaAllocatorContext)
+    FrameAreaScope(const FrameAreaScope&) = delete;
+    FrameAreaScope& operator=(const FrameAreaScope&) = delete;
+};
\ No newline at end of file
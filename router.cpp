@@ -0,0 +1,135 @@
+#include "router.hpp"
+#include <cstring>
+
+void Router::add(HttpMethod method, const std::string &pattern,
+                 Handler handler) {
+  Node *node = &roots[static_cast<int>(method)];
+  size_t pos = 0;
+
+  while (pos < pattern.size()) {
+    if (pattern[pos] == ':') {
+      // Parameter segment: one node capturing everything up to the next '/'
+      size_t end = pattern.find('/', pos);
+      if (end == std::string::npos) {
+        end = pattern.size();
+      }
+      std::string name = pattern.substr(pos + 1, end - pos - 1);
+
+      if (!node->param_child) {
+        node->param_child = new Node;
+        node->param_child->param_name = name;
+      }
+      node = node->param_child;
+      pos = end;
+      continue;
+    }
+
+    // Literal run up to the next parameter marker
+    size_t lit_end = pattern.find(':', pos);
+    if (lit_end == std::string::npos) {
+      lit_end = pattern.size();
+    }
+    node = insertLiteral(node, pattern.substr(pos, lit_end - pos));
+    pos = lit_end;
+  }
+
+  node->has_handler = true;
+  node->handler = handler;
+}
+
+Router::Node *Router::insertLiteral(Node *node, const std::string &literal) {
+  size_t pos = 0;
+
+  while (pos < literal.size()) {
+    Node *child = nullptr;
+    for (Node *candidate : node->children) {
+      if (candidate->prefix[0] == literal[pos]) {
+        child = candidate;
+        break;
+      }
+    }
+
+    if (!child) {
+      child = new Node;
+      child->prefix = literal.substr(pos);
+      node->children.push_back(child);
+      return child;
+    }
+
+    size_t common = 0;
+    while (common < child->prefix.size() && pos + common < literal.size() &&
+           child->prefix[common] == literal[pos + common]) {
+      common++;
+    }
+
+    if (common < child->prefix.size()) {
+      // Partial overlap - split the child so the shared bytes become the
+      // parent and the diverging tail keeps the child's payload
+      Node *tail = new Node;
+      tail->prefix = child->prefix.substr(common);
+      tail->children = std::move(child->children);
+      tail->param_child = child->param_child;
+      tail->has_handler = child->has_handler;
+      tail->handler = std::move(child->handler);
+
+      child->prefix = child->prefix.substr(0, common);
+      child->children.clear();
+      child->children.push_back(tail);
+      child->param_child = nullptr;
+      child->has_handler = false;
+      child->handler = nullptr;
+    }
+
+    node = child;
+    pos += common;
+  }
+
+  return node;
+}
+
+Router::Handler *Router::find(HttpMethod method, const char *path, size_t len,
+                              std::map<std::string, std::string> &params) {
+  return search(&roots[static_cast<int>(method)], path, len, params);
+}
+
+Router::Handler *Router::search(Node *node, const char *path, size_t len,
+                                std::map<std::string, std::string> &params) {
+  if (len == 0) {
+    return node->has_handler ? &node->handler : nullptr;
+  }
+
+  // Literal children first - at most one can match since first bytes are
+  // unique; fall back to the parameter child if the literal branch dead-ends
+  for (Node *child : node->children) {
+    if (child->prefix[0] != path[0]) {
+      continue;
+    }
+    if (child->prefix.size() <= len &&
+        memcmp(child->prefix.data(), path, child->prefix.size()) == 0) {
+      Handler *handler = search(child, path + child->prefix.size(),
+                                len - child->prefix.size(), params);
+      if (handler) {
+        return handler;
+      }
+    }
+    break;
+  }
+
+  if (node->param_child) {
+    size_t segment = 0;
+    while (segment < len && path[segment] != '/') {
+      segment++;
+    }
+    if (segment > 0) {
+      Handler *handler =
+          search(node->param_child, path + segment, len - segment, params);
+      if (handler) {
+        // Capture on the way back out so failed branches leave no params
+        params[node->param_child->param_name] = std::string(path, segment);
+        return handler;
+      }
+    }
+  }
+
+  return nullptr;
+}
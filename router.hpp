@@ -0,0 +1,51 @@
+#pragma once
+
+#include "http_message.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Compressed radix-tree router with one subtree per HTTP method. Literal
+// path bytes are packed into node prefixes (so /api/users and /api/orders
+// share an /api/ node), and ":name" segments become parameter nodes that
+// capture one path segment into HttpRequest::params. Lookup walks the tree
+// once - O(path length) regardless of how many routes are registered - and
+// allocates nothing except the captured parameter values on a match.
+struct Router {
+  using Handler = std::function<void(HttpRequest &, HttpResponse &)>;
+
+  struct Node {
+    std::string prefix = "";          // literal bytes this node consumes
+    std::vector<Node *> children = {}; // literal children, unique first byte
+    Node *param_child = nullptr;       // matches one segment (up to '/')
+    std::string param_name = "";
+    bool has_handler = false;
+    Handler handler = nullptr;
+
+    ~Node() {
+      for (Node *child : children) {
+        delete child;
+      }
+      delete param_child;
+    }
+  };
+
+  // Root per method, indexed by HttpMethod
+  Node roots[6] = {};
+
+  // Register a pattern like /users/:id/posts for a method
+  void add(HttpMethod method, const std::string &pattern, Handler handler);
+
+  // Match a request path; returns the handler or nullptr. Captured ":name"
+  // segments are written into params only when the route matches.
+  Handler *find(HttpMethod method, const char *path, size_t len,
+                std::map<std::string, std::string> &params);
+
+  // Descend through literal bytes, splitting nodes on partial prefix
+  // overlap; returns the node sitting exactly at the end of `literal`
+  Node *insertLiteral(Node *node, const std::string &literal);
+
+  static Handler *search(Node *node, const char *path, size_t len,
+                         std::map<std::string, std::string> &params);
+};
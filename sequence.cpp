@@ -4,8 +4,28 @@
 
 Sequence::Sequence(Poller &poller) : poller(poller) {}
 
+Sequence::~Sequence() { detachTokens(); }
+
+void Sequence::CompletionToken::signal() {
+  if (!state) {
+    return;
+  }
+  if (state->signaled.exchange(true)) {
+    return; // already signalled
+  }
+
+  // Hop to the poller thread; the sequence pointer is only ever touched
+  // there, so a token outliving its sequence degrades to a no-op post
+  auto shared = state;
+  state->poller->post([shared]() {
+    if (shared->sequence) {
+      shared->sequence->onTokenSignaled(shared);
+    }
+  });
+}
+
 void Sequence::addTask(Poller::TimerCallback callback) {
-  tasks.push_back({callback, 0, false});
+  tasks.push_back({std::move(callback), 0, false});
 }
 
 void Sequence::addWait(uint32_t period_ms) {
@@ -19,7 +39,48 @@ void Sequence::addWait(std::function<bool()> condition, uint32_t period_ms,
   tasks.push_back({[] {}, period_ms, true, condition, timeout_ms});
 }
 
+Sequence::CompletionToken Sequence::waitFor(uint32_t timeout_ms) {
+  auto state = std::make_shared<TokenState>();
+  state->sequence = this;
+  state->poller = &poller;
+
+  SequenceTask task = {};
+  task.period_ms = 0;
+  task.timeout_ms = timeout_ms;
+  task.token = state;
+  tasks.push_back(std::move(task));
+
+  return CompletionToken{state};
+}
+
+void Sequence::detachTokens() {
+  for (auto &task : tasks) {
+    if (task.token) {
+      task.token->sequence = nullptr;
+    }
+  }
+}
+
+void Sequence::onTokenSignaled(const std::shared_ptr<TokenState> &state) {
+  if (!running || paused || current_task_index >= tasks.size()) {
+    return; // latched flag advances the step when it becomes current
+  }
+
+  if (tasks[current_task_index].token != state) {
+    return; // signalled ahead of its turn - the latch covers it
+  }
+
+  // Cancel the timeout timer (if any) before moving on so it can't fire
+  // against a later task
+  if (current_timer_id != 0) {
+    poller.clearTimeout(current_timer_id);
+    current_timer_id = 0;
+  }
+  postNextTask();
+}
+
 void Sequence::clearTasks() {
+  detachTokens();
   tasks.clear();
   current_task_index = 0;
 
@@ -78,6 +139,30 @@ void Sequence::executeNextTask() {
   }
 
   const auto &task = tasks[current_task_index];
+
+  // Event-driven wait step: advance right away if the token was signalled
+  // before we got here, otherwise park with no timer at all (or just the
+  // timeout bound) until signal() posts the wakeup
+  if (task.token) {
+    if (task.token->signaled.load()) {
+      postNextTask();
+      return;
+    }
+    task_timer.reset();
+    remaining_time_ms = 0;
+    if (task.timeout_ms > 0) {
+      current_timer_id = poller.setTimeout(task.timeout_ms, [this]() {
+        if (!running || paused || current_task_index >= tasks.size()) {
+          return;
+        }
+        if (tasks[current_task_index].token) {
+          postNextTask(); // timed out unsignalled - move on
+        }
+      });
+    }
+    return;
+  }
+
   // Use remaining time from pause if available, otherwise use task's original
   // period
   uint32_t period_to_use =
@@ -87,19 +172,21 @@ void Sequence::executeNextTask() {
   task_timer.reset();
   remaining_time_ms = 0; // Reset remaining time since we're using it now
 
-  // Set up a timer for this task
-  current_timer_id = poller.setTimeout(period_to_use, [this, task]() {
-    if (!running || paused) {
+  // Set up a timer for this task (looked up by index when it fires - the
+  // task itself holds a move-only callback and stays in the vector)
+  current_timer_id = poller.setTimeout(period_to_use, [this]() {
+    if (!running || paused || current_task_index >= tasks.size()) {
       return;
     }
 
-    if (task.is_condition) {
+    auto &current = tasks[current_task_index];
+    if (current.is_condition) {
 
       executeCondition();
 
     } else {
 
-      task.callback();
+      current.callback();
 
       postNextTask();
     }
@@ -6,20 +6,52 @@
 #include "steady_clock.hpp"
 #include "steady_timer.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <vector>
 
 struct Sequence {
   // Constructor
   Sequence(Poller &poller);
+  ~Sequence();
+
+  // Shared between a parked wait step and any thread holding the token.
+  // signaled latches, so a signal that arrives before the sequence reaches
+  // its wait step is remembered; sequence is nulled when the owning
+  // Sequence clears its tasks or is destroyed, turning late signals into
+  // no-ops.
+  struct TokenState {
+    std::atomic<bool> signaled{false};
+    Sequence *sequence = nullptr; // poller thread only
+    Poller *poller = nullptr;
+  };
+
+  // Handle returned by waitFor(). signal() is safe from any thread: the
+  // wakeup is routed through the poller's cross-thread post, so the
+  // sequence advances on the poller thread. Copyable; signalling twice is
+  // a no-op.
+  struct CompletionToken {
+    std::shared_ptr<TokenState> state = nullptr;
+    void signal();
+  };
 
   // Tasks
   void addTask(Poller::TimerCallback callback);
   void addWait(uint32_t period_ms);
   void addWait(std::function<bool()> condition, uint32_t period_ms = 10,
                uint32_t timeout_ms = 1000);
+
+  // Event-driven wait: parks the sequence until the returned token is
+  // signalled - no polling timer, no per-period wakeups, and the step
+  // advances as soon as the poller drains its posted tasks instead of up
+  // to a poll period later. timeout_ms > 0 bounds the wait (the sequence
+  // moves on unsignalled when it expires). Polling addWait stays available
+  // for genuinely time-based conditions.
+  CompletionToken waitFor(uint32_t timeout_ms = 0);
+
   void clearTasks();
 
   // Control
@@ -37,16 +69,23 @@ protected:
 
   void executeCondition();
 
+  // Poller thread, via CompletionToken::signal()'s post
+  void onTokenSignaled(const std::shared_ptr<TokenState> &state);
+  void detachTokens();
+
 private:
   using TimePoint = SteadyClock::TimePoint;
   struct SequenceTask {
-    std::function<void()> callback = [] {};
+    Poller::TimerCallback callback = [] {};
     size_t period_ms;
     bool is_condition = false;
 
     // use for wait condition
     std::function<bool()> condition;
     uint32_t timeout_ms;
+
+    // set for waitFor() steps
+    std::shared_ptr<TokenState> token = nullptr;
   };
 
   std::vector<SequenceTask> tasks;
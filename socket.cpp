@@ -1,32 +1,123 @@
 #include "socket.hpp"
 #include "poller.hpp"
+#include "poller_memory.hpp"
+#include <fcntl.h>
+#include <limits.h>
+#include <map>
+#include <mutex>
 #include <netdb.h>
+#include <netinet/tcp.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <vector>
+
+// Pooled read buffer shared by all sockets on a poller thread: one 256KB
+// area, reset and handed out again for every read event - no per-read heap
+// allocation, and bulk transfers arrive in large chunks instead of 1KB reads
+static constexpr size_t SOCKET_READ_AREA_SIZE = 256 * 1024;
+
+static AreaAllocatorBase *socketReadArea() {
+  static thread_local ManagedArea read_area(SOCKET_READ_AREA_SIZE,
+                                            "socket_read");
+  return read_area.get_allocator();
+}
+
+// Small TTL-respecting DNS result cache shared by all sockets. getaddrinfo
+// doesn't expose record TTLs, so entries are kept for a fixed period that is
+// short enough to follow DNS changes but long enough that repeated client
+// connects to the same host skip resolution entirely.
+static constexpr int DNS_CACHE_TTL_MS = 60 * 1000;
+
+struct DnsCacheEntry {
+  struct in_addr addr;
+  SteadyClock::TimePoint expiry;
+};
+
+static std::mutex dns_cache_mutex;
+static std::map<std::string, DnsCacheEntry> dns_cache;
+
+static bool lookupDnsCache(const std::string &host, struct in_addr *addr) {
+  std::lock_guard<std::mutex> lock(dns_cache_mutex);
+  auto it = dns_cache.find(host);
+  if (it == dns_cache.end()) {
+    return false;
+  }
+  if (SteadyClock::now() >= it->second.expiry) {
+    dns_cache.erase(it); // expired
+    return false;
+  }
+  *addr = it->second.addr;
+  return true;
+}
+
+static void storeDnsCache(const std::string &host, struct in_addr addr) {
+  std::lock_guard<std::mutex> lock(dns_cache_mutex);
+  dns_cache[host] = DnsCacheEntry{
+      addr, SteadyClock::addMilliseconds(SteadyClock::now(), DNS_CACHE_TTL_MS)};
+}
+
+// Blocking resolution of the first IPv4 address for host
+static bool resolveHost(const std::string &host, struct in_addr *addr) {
+  struct addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+
+  struct addrinfo *result = nullptr;
+  int res = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+  if (res != 0 || !result) {
+    return false;
+  }
+
+  *addr = reinterpret_cast<struct sockaddr_in *>(result->ai_addr)->sin_addr;
+  freeaddrinfo(result);
+  return true;
+}
 
 Socket::Socket() : Pollable() {
   type = PollableType::SOCKET;
 
   onEvent = [this](short revents) {
     if (file_descriptor >= 0) {
+      if (connect_pending && (revents & (POLLOUT | POLLERR | POLLHUP))) {
+        finishConnect(revents);
+        if (file_descriptor < 0) {
+          return; // Connect failed, fd is gone
+        }
+      }
       if (revents & POLLIN) {
-        char buffer[1024];
-        ssize_t bytes_read = read(file_descriptor, buffer, sizeof(buffer));
-        if (bytes_read > 0) {
-          BufferView view{buffer, static_cast<size_t>(bytes_read)};
-          if (onData) {
-            onData(*this, view);
+        if (drain_reads) {
+          drainReadBuffer();
+        } else {
+          char buffer[1024];
+          ssize_t bytes_read = read(file_descriptor, buffer, sizeof(buffer));
+          if (bytes_read > 0) {
+            if (poller) {
+              poller->metrics.countBytesRead(bytes_read);
+            }
+            BufferView view{buffer, static_cast<size_t>(bytes_read)};
+            deliverData(view);
           }
         }
       }
-      if ((revents & POLLOUT) && write_buffer.size() > 0) {
-        std::vector<char> temp_buffer;
-        temp_buffer.reserve(std::min(write_buffer.size(), size_t(1024)));
-        for (size_t i = 0; i < temp_buffer.capacity(); ++i) {
-          temp_buffer.push_back(write_buffer.getAt(i));
+      if ((revents & POLLOUT) && !connect_pending && wantsPollout()) {
+        size_t before_flush = pendingBytes();
+        if (write_buffer.size() > 0 || !shared_queue.empty()) {
+          flushWriteBuffer();
+        }
+        // File bytes follow the buffered headers
+        if (write_buffer.size() == 0 && shared_queue.empty() &&
+            sendfile_remaining > 0) {
+          flushSendFile();
         }
-        ssize_t bytes_written =
-            ::write(file_descriptor, temp_buffer.data(), temp_buffer.size());
-        if (bytes_written > 0) {
-          write_buffer.clear();
+        if (close_after_flush && !wantsPollout()) {
+          stop();
+        } else if (onDrain && before_flush > drain_threshold &&
+                   pendingBytes() <= drain_threshold) {
+          // Fire only on the downward crossing so a consumer that stays
+          // below the threshold isn't re-notified every wakeup
+          onDrain(*this);
         }
       }
     }
@@ -68,33 +159,481 @@ bool Socket::start(const std::string &host, uint16_t port) {
     return false;
   }
 
+  // Drain-mode reads rely on recv returning EAGAIN once empty
+  setNonBlocking();
+
   remote_addr = host;
   remote_port = port;
   return true;
 }
 
+bool Socket::startUnix(const std::string &path) {
+  file_descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    std::cerr << "Unix socket path too long: " << path << std::endl;
+    return false;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  if (::connect(file_descriptor, reinterpret_cast<struct sockaddr *>(&addr),
+                sizeof(addr)) < 0) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    std::cerr << "Failed to connect to unix socket " << path << std::endl;
+    return false;
+  }
+
+  unix_domain = true;
+  applyUnixBufferSizes();
+  setNonBlocking();
+
+  remote_addr = path;
+  remote_port = 0;
+  return true;
+}
+
+void Socket::applyUnixBufferSizes() {
+  int size = UNIX_BUFFER_SIZE;
+  setsockopt(file_descriptor, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+  setsockopt(file_descriptor, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+bool Socket::sendFds(const int *fds, size_t count, const void *data,
+                     size_t len) {
+  if (!unix_domain || file_descriptor < 0 || count == 0) {
+    return false;
+  }
+  // sendmsg bypasses write_buffer; queued bytes would be reordered behind
+  // the carrier payload, so refuse until the write path is empty
+  if (pendingBytes() > 0) {
+    return false;
+  }
+
+  char nul = '\0';
+  struct iovec iov;
+  iov.iov_base = len > 0 ? const_cast<void *>(data) : &nul;
+  iov.iov_len = len > 0 ? len : 1;
+
+  std::vector<char> cmsg_buf(CMSG_SPACE(count * sizeof(int)));
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cmsg_buf.data();
+  msg.msg_controllen = cmsg_buf.size();
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(count * sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), fds, count * sizeof(int));
+
+  ssize_t sent = sendmsg(file_descriptor, &msg, MSG_NOSIGNAL);
+  if (sent < 0) {
+    std::cerr << "sendFds failed: " << strerror(errno) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+ssize_t Socket::recvWithFds(char *buffer, size_t len) {
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = len;
+
+  // Room for a handful of fds per read - SCM_RIGHTS handoffs are one or two
+  // fds at a time, not bulk transfers
+  char cmsg_buf[CMSG_SPACE(8 * sizeof(int))];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cmsg_buf;
+  msg.msg_controllen = sizeof(cmsg_buf);
+
+  ssize_t bytes_read = recvmsg(file_descriptor, &msg, MSG_CMSG_CLOEXEC);
+  if (bytes_read <= 0) {
+    return bytes_read;
+  }
+
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    int received[8];
+    std::memcpy(received, CMSG_DATA(cmsg), count * sizeof(int));
+    for (size_t i = 0; i < count; i++) {
+      onFdReceived(*this, received[i]);
+    }
+  }
+  return bytes_read;
+}
+
 void Socket::write(const Buffer &data) {
-  bool was_empty = write_buffer.size() == 0;
-  // Copy data from Buffer to write_buffer
-  for (size_t i = 0; i < data.size(); ++i) {
-    char byte = data.getAt(i);
-    write_buffer.append(&byte, 1);
+  if (!shared_queue.empty()) {
+    materializeSharedQueue(); // keep byte order across the two queues
+  }
+  // Copy data block-wise instead of byte-by-byte via getAt
+  write_buffer.append(data);
+  requestFlush();
+}
+
+void Socket::requestFlush() {
+  if (!poller) {
+    return;
+  }
+  if (!flush_scheduled) {
+    flush_scheduled = true;
+    poller->scheduleFlush(id);
+  }
+  // Big burst from one handler: push it to the kernel now instead of letting
+  // the buffer balloon until the end of the iteration. Goes through onEvent
+  // so a wrapped handler (TLS) runs its own write path; connect_pending is
+  // excluded because a synthetic POLLOUT would be read as connect completion.
+  if (pendingBytes() >= FLUSH_EAGER_THRESHOLD && !connect_pending) {
+    onEvent(POLLOUT);
+  }
+}
+
+bool Socket::connectAsync(const std::string &host, uint16_t port) {
+  if (!poller) {
+    return false;
+  }
+
+  remote_addr = host;
+  remote_port = port;
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+
+  // Cache hit - connect straight away, no resolver round trip
+  if (lookupDnsCache(host, &addr.sin_addr)) {
+    return beginConnect(addr);
+  }
+
+  // Offload resolution to the executor so a slow DNS server can't stall the
+  // event loop; the result is posted back so the non-blocking connect (and
+  // any onConnect failure callback) runs on the poller thread
+  if (!poller->executor.isRunning()) {
+    poller->executor.start();
   }
 
-  // Enable POLLOUT if buffer was empty (so we weren't monitoring for write
-  // events)
-  if (was_empty && poller) {
+  poller->executor.submit([this, host, addr]() mutable {
+    if (!resolveHost(host, &addr.sin_addr)) {
+      std::cerr << "Failed to resolve address " << host << std::endl;
+      poller->post([this]() { onConnect(*this, false); });
+      return;
+    }
+    storeDnsCache(host, addr.sin_addr);
+    poller->post([this, addr]() { beginConnect(addr); });
+  });
+
+  return true;
+}
+
+bool Socket::beginConnect(struct sockaddr_in addr) {
+  file_descriptor = socket(AF_INET, SOCK_STREAM, 0);
+  if (file_descriptor < 0) {
+    onConnect(*this, false);
+    return false;
+  }
+
+  setNonBlocking();
+
+  int res = ::connect(file_descriptor, reinterpret_cast<struct sockaddr *>(&addr),
+                      sizeof(addr));
+  if (res == 0) {
+    // Connected immediately (e.g. loopback)
+    onConnect(*this, true);
+    if (poller && write_buffer.size() > 0) {
+      poller->enablePollout(id);
+      poller->notify();
+    }
+    return true;
+  }
+
+  if (errno != EINPROGRESS) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    onConnect(*this, false);
+    return false;
+  }
+
+  // In flight - POLLOUT fires when the handshake finishes (or fails)
+  connect_pending = true;
+  if (poller) {
     poller->enablePollout(id);
+    poller->notify();
+  }
+  return true;
+}
+
+void Socket::finishConnect(short revents) {
+  connect_pending = false;
+
+  int error = 0;
+  socklen_t len = sizeof(error);
+  if (getsockopt(file_descriptor, SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+    error = errno;
+  }
+  if (error == 0 && (revents & (POLLERR | POLLHUP))) {
+    error = ECONNREFUSED;
+  }
+
+  if (error != 0) {
+    close(file_descriptor);
+    file_descriptor = -1;
+    onConnect(*this, false);
+    return;
+  }
+
+  onConnect(*this, true);
+}
+
+void Socket::stop() {
+  if (file_descriptor < 0) {
+    return; // never started or already stopped
+  }
+  close(file_descriptor);
+  file_descriptor = -1;
+
+  if (sendfile_fd >= 0) {
+    close(sendfile_fd);
+    sendfile_fd = -1;
+    sendfile_remaining = 0;
+  }
+  shared_queue.clear(); // release broadcast refs promptly
+
+  if (onClose) {
+    onClose(*this);
+  }
+
+  if (poller) {
+    // Defer pool removal to the cleanup phase of the poller loop - the
+    // slot (and this object) stays alive until the current dispatch is done
+    Poller *owner = poller;
+    PollableID socket_id = id;
+    owner->cleanupTasks.push_back(
+        [owner, socket_id]() { owner->removePollable(socket_id); });
+  }
+}
+
+void Socket::deliverData(const BufferView &view) {
+  if (onDataChain) {
+    // A fresh recv always yields one contiguous region; parsers holding
+    // leftover partial-message bytes can prepend them on their own chain
+    onDataChain(*this, BufferChain(view));
+  } else if (onData) {
+    onData(*this, view);
+  }
+}
+
+bool Socket::setNoDelay(bool on) {
+  int val = on ? 1 : 0;
+  return setsockopt(file_descriptor, IPPROTO_TCP, TCP_NODELAY, &val,
+                    sizeof(val)) == 0;
+}
+
+bool Socket::setCork(bool on) {
+  int val = on ? 1 : 0;
+  return setsockopt(file_descriptor, IPPROTO_TCP, TCP_CORK, &val,
+                    sizeof(val)) == 0;
+}
+
+bool Socket::setNonBlocking() {
+  int flags = fcntl(file_descriptor, F_GETFL, 0);
+  if (flags == -1) {
+    return false;
+  }
+  return fcntl(file_descriptor, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+void Socket::drainReadBuffer() {
+  AreaAllocatorBase *area = socketReadArea();
+  bool peer_closed = false;
+
+  while (file_descriptor >= 0) {
+    // Recycle the whole pooled area as one large contiguous read buffer
+    area->reset();
+    char *buffer = static_cast<char *>(
+        area->allocate_raw(SOCKET_READ_AREA_SIZE, alignof(char)));
+
+    size_t filled = 0;
+    while (filled < SOCKET_READ_AREA_SIZE) {
+      // Unix sockets expecting passed fds must read with recvmsg - plain
+      // recv makes the kernel close any SCM_RIGHTS fds in flight
+      ssize_t bytes_read =
+          (unix_domain && onFdReceived)
+              ? recvWithFds(buffer + filled, SOCKET_READ_AREA_SIZE - filled)
+              : recv(file_descriptor, buffer + filled,
+                     SOCKET_READ_AREA_SIZE - filled, 0);
+      if (bytes_read == 0) {
+        peer_closed = true; // orderly shutdown from the other side
+        break;
+      }
+      if (bytes_read < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+          break; // drained - wait for the next readable event
+        }
+        peer_closed = true; // ECONNRESET and friends: tear down below
+        break;
+      }
+      filled += bytes_read;
+    }
+
+    if (filled > 0) {
+      if (poller) {
+        poller->metrics.countBytesRead(filled);
+      }
+      BufferView view{buffer, filled};
+      deliverData(view);
+    }
+
+    if (filled < SOCKET_READ_AREA_SIZE) {
+      break; // fd is drained - wait for the next readable event
+    }
+    // Buffer was filled to capacity; there may be more pending, keep going
+  }
+
+  // Deliver any final bytes first, then tear the connection down so it
+  // doesn't sit in the poll set forever
+  if (peer_closed) {
+    stop();
+  }
+}
+
+void Socket::flushWriteBuffer() {
+  // Scatter-gather send: hand the buffer's slab slices to the kernel as one
+  // writev call instead of copying them into a temporary. Partial writes
+  // only advance the consume cursor; nothing is re-copied or re-sent.
+  size_t count =
+      std::min(write_buffer.sliceCount(), static_cast<size_t>(IOV_MAX));
+  std::vector<struct iovec> iov;
+  iov.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    Buffer::Slice slice = write_buffer.sliceAt(i);
+    struct iovec vec;
+    vec.iov_base = const_cast<char *>(slice.data);
+    vec.iov_len = slice.size;
+    iov.push_back(vec);
+  }
+  // Anything beyond IOV_MAX slices goes out on the next POLLOUT wakeup
+
+  // Shared broadcast segments ride the same writev, after the buffer bytes
+  // (only once every buffer slice fit, so ordering holds)
+  if (count == write_buffer.sliceCount()) {
+    for (const SharedSegment &segment : shared_queue) {
+      if (iov.size() >= static_cast<size_t>(IOV_MAX)) {
+        break;
+      }
+      struct iovec vec;
+      vec.iov_base =
+          const_cast<char *>(segment.data->data()) + segment.offset;
+      vec.iov_len = segment.data->size() - segment.offset;
+      iov.push_back(vec);
+    }
+  }
+
+  if (iov.empty()) {
+    return;
+  }
+
+  ssize_t bytes_written = ::writev(file_descriptor, iov.data(), iov.size());
+  if (bytes_written > 0) {
+    if (poller) {
+      poller->metrics.countBytesWritten(bytes_written);
+    }
+    // Account buffer bytes first, then advance shared-segment offsets
+    size_t remaining = static_cast<size_t>(bytes_written);
+    size_t from_buffer = std::min(remaining, write_buffer.size());
+    write_buffer.consume(from_buffer);
+    remaining -= from_buffer;
+    while (remaining > 0 && !shared_queue.empty()) {
+      SharedSegment &front = shared_queue.front();
+      size_t left = front.data->size() - front.offset;
+      if (remaining >= left) {
+        shared_queue.pop_front();
+        remaining -= left;
+      } else {
+        front.offset += remaining;
+        remaining = 0;
+      }
+    }
+  }
+}
+
+void Socket::writeShared(std::shared_ptr<const std::string> data) {
+  if (!data || data->empty()) {
+    return;
+  }
+  shared_queue.push_back(SharedSegment{std::move(data), 0});
+  requestFlush();
+}
+
+void Socket::materializeSharedQueue() {
+  for (const SharedSegment &segment : shared_queue) {
+    write_buffer.append(segment.data->data() + segment.offset,
+                        segment.data->size() - segment.offset);
+  }
+  shared_queue.clear();
+}
+
+void Socket::sendFile(int fd, off_t offset, size_t count) {
+  if (sendfile_fd >= 0) {
+    close(sendfile_fd); // only one transfer in flight per socket
+  }
+  sendfile_fd = fd;
+  sendfile_offset = offset;
+  sendfile_remaining = count;
+
+  requestFlush();
+  if (poller) {
+    poller->notify();
+  }
+}
+
+void Socket::flushSendFile() {
+  while (sendfile_remaining > 0) {
+    // sendfile advances sendfile_offset by the amount transferred
+    ssize_t sent = ::sendfile(file_descriptor, sendfile_fd, &sendfile_offset,
+                              sendfile_remaining);
+    if (sent <= 0) {
+      break; // EAGAIN (socket full) or error; retry on the next POLLOUT
+    }
+    if (poller) {
+      poller->metrics.countBytesWritten(sent);
+    }
+    sendfile_remaining -= static_cast<size_t>(sent);
+  }
+
+  if (sendfile_remaining == 0 && sendfile_fd >= 0) {
+    close(sendfile_fd);
+    sendfile_fd = -1;
   }
 }
 
 void Socket::write(const std::string &data) {
-  bool was_empty = write_buffer.size() == 0;
+  if (!shared_queue.empty()) {
+    materializeSharedQueue(); // keep byte order across the two queues
+  }
   write_buffer.append(data.data(), data.size());
+  requestFlush();
+}
 
-  // Enable POLLOUT if buffer was empty (so we weren't monitoring for write
-  // events)
-  if (was_empty && poller) {
-    poller->enablePollout(id);
+void Socket::write(const char *data, size_t len) {
+  if (!shared_queue.empty()) {
+    materializeSharedQueue(); // keep byte order across the two queues
   }
+  write_buffer.append(data, len);
+  requestFlush();
 }
@@ -2,18 +2,23 @@
 
 #include "any.hpp"
 #include "buffer.hpp"
+#include "buffer_chain.hpp"
 #include "buffer_view.hpp"
+#include "inplace_function.hpp"
 #include "pollable.hpp"
 #include <arpa/inet.h>
 #include <cstring> // for strerror
+#include <deque>
 #include <errno.h> // for errno
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <netinet/in.h>
 #include <string>
 #include <sys/socket.h>
 #include <unistd.h>
 
+class AreaAllocatorBase;
 
 struct Socket : Pollable {
 
@@ -23,16 +28,199 @@ struct Socket : Pollable {
   Buffer read_buffer = Buffer{};
   Buffer write_buffer = Buffer{};
 
+  // When true (default) a readable event drains the fd with recv until
+  // EAGAIN into a pooled large buffer and delivers big BufferViews; when
+  // false each event reads a single small chunk (legacy behavior)
+  bool drain_reads = true;
+
   // for higher application protocol
   Any userData;
 
-  using Callback = std::function<void(Socket &, const BufferView &)>;
+  // Per-connection bump area attached by the accept path when area
+  // allocators are on (USE_AREA_ALLOCATORS); released and reset in
+  // Poller::removePollable. Null for outbound sockets and when the
+  // feature is off.
+  AreaAllocatorBase *connection_area = nullptr;
+
+  using Callback = InplaceFunction<void(Socket &, const BufferView &)>;
   Callback onData = [](Socket &, const BufferView &) {};
 
+  // Zero-copy variant of onData: receives the incoming bytes as a
+  // BufferChain (span-of-spans) instead of a flat view. When set it takes
+  // precedence over onData, so protocol parsers that can walk segments
+  // avoid the flatten-into-one-allocation step entirely.
+  using ChainCallback = InplaceFunction<void(Socket &, const BufferChain &)>;
+  ChainCallback onDataChain;
+
+  using ConnectCallback = InplaceFunction<void(Socket &, bool ok)>;
+  ConnectCallback onConnect = [](Socket &, bool) {};
+
+  // Fires when the socket is torn down (peer hangup, stop(), or a server
+  // reaping an idle connection) so owners can drop their bookkeeping
+  using CloseCallback = InplaceFunction<void(Socket &)>;
+  CloseCallback onClose = [](Socket &) {};
+
+  // Fires after a POLLOUT flush brings pendingBytes() from above
+  // drain_threshold to at or below it - the cue for a streaming producer to
+  // push its next batch of bytes. With the default threshold of 0 that
+  // means "fully drained". Unset by default.
+  using DrainCallback = InplaceFunction<void(Socket &)>;
+  DrainCallback onDrain;
+  size_t drain_threshold = 0;
+
+  // Transport is a unix domain socket (set by startUnix and the unix accept
+  // path) - enables the recvmsg read variant that can carry SCM_RIGHTS
+  bool unix_domain = false;
+
+  // Kernel send/receive buffer size applied to unix domain sockets. The
+  // AF_UNIX default (~208KB) is sized for chatty IPC; local bulk transfer
+  // between co-located processes wants a deeper pipe.
+  static constexpr int UNIX_BUFFER_SIZE = 1024 * 1024;
+
+  // Fires once per file descriptor received over a unix domain socket via
+  // SCM_RIGHTS, before the data callback for the bytes it rode in with.
+  // The fd is owned by the callee. Unset by default - without it ancillary
+  // fds sent by the peer are closed by the kernel on the plain recv path.
+  using FdCallback = InplaceFunction<void(Socket &, int fd)>;
+  FdCallback onFdReceived;
+
+  // An in-flight non-blocking connect is awaiting POLLOUT completion
+  bool connect_pending = false;
+
+  // Already queued in the poller's per-iteration flush list (dedupe so a
+  // handler calling write() five times schedules one flush, not five)
+  bool flush_scheduled = false;
+
+  // Consecutive governor sweeps this socket spent over the write-buffer
+  // cap; reset the moment it drains back under (see Poller::governorSweep)
+  uint32_t over_cap_sweeps = 0;
+
+  // A single handler queueing this much is flushed inline rather than held
+  // until the end of the iteration, bounding buffer growth for bulk senders
+  static constexpr size_t FLUSH_EAGER_THRESHOLD = 64 * 1024;
+
+  // Close the connection once write_buffer fully drains (half of HTTP
+  // "Connection: close": the response must reach the kernel first)
+  bool close_after_flush = false;
+
+  // In-flight sendfile(2) transfer, queued behind write_buffer so headers
+  // always go out first. The fd is owned by the socket once queued.
+  int sendfile_fd = -1;
+  off_t sendfile_offset = 0;
+  size_t sendfile_remaining = 0;
+
+  // Reference-counted segments shared across many sockets (broadcast
+  // fan-out): the bytes are serialized once and each socket queues only a
+  // pointer plus a partial-send offset. Flushed after write_buffer in the
+  // same writev; a plain write() while segments are queued copies them into
+  // write_buffer first so byte order is preserved.
+  struct SharedSegment {
+    std::shared_ptr<const std::string> data;
+    size_t offset = 0;
+  };
+  std::deque<SharedSegment> shared_queue = {};
+
   Socket();
 
   bool start(const std::string &host, uint16_t port);
 
+  // Connect to a unix domain socket at `path` (blocking, like start).
+  // Local IPC without the TCP/IP stack: no checksums or loopback routing,
+  // and the fd supports SCM_RIGHTS fd passing (sendFds / onFdReceived).
+  bool startUnix(const std::string &path);
+
+  // Hand `count` file descriptors to the peer over a unix domain socket via
+  // SCM_RIGHTS, riding on `len` bytes of payload (a single NUL byte when no
+  // payload is given - stream sockets cannot carry ancillary data alone).
+  // Sent immediately with sendmsg, bypassing write_buffer; fails if bytes
+  // are still queued, so flush (or write nothing) before passing fds.
+  bool sendFds(const int *fds, size_t count, const void *data = nullptr,
+               size_t len = 0);
+
+  // recvmsg read used by drainReadBuffer when onFdReceived is set: collects
+  // SCM_RIGHTS fds (delivered through the callback) along with the bytes
+  ssize_t recvWithFds(char *buffer, size_t len);
+
+  // Apply UNIX_BUFFER_SIZE to both kernel buffer directions (called by the
+  // unix connect and accept paths)
+  void applyUnixBufferSizes();
+
+  // Asynchronous connection establishment: DNS resolution runs on the
+  // poller's Executor (with a TTL-respecting cache, so repeated connects to
+  // the same host skip it), the connect itself is non-blocking and completes
+  // via POLLOUT. onConnect(ok) fires when the outcome is known; writes issued
+  // before completion are buffered and flushed once connected.
+  bool connectAsync(const std::string &host, uint16_t port);
+
   void write(const Buffer &data);
   void write(const std::string &data);
+  void write(const char *data, size_t len);
+
+  // Queue refcounted bytes without copying them (broadcast fan-out path)
+  void writeShared(std::shared_ptr<const std::string> data);
+
+  // Copy pending shared segments into write_buffer (ordering fallback when
+  // a plain write() follows a writeShared())
+  void materializeSharedQueue();
+
+  // Flush as much of write_buffer as the kernel accepts with a single
+  // writev over the buffer's blocks (called on POLLOUT)
+  void flushWriteBuffer();
+
+  // Queue count bytes of fd (from offset) for zero-copy transmission with
+  // sendfile(2) once write_buffer has drained. Takes ownership of fd - it
+  // is closed when the transfer completes or the socket stops.
+  void sendFile(int fd, off_t offset, size_t count);
+
+  // Push queued sendfile bytes until EAGAIN (called on POLLOUT)
+  void flushSendFile();
+
+  // Whether POLLOUT should stay armed for this socket
+  bool wantsPollout() const {
+    return write_buffer.size() > 0 || !shared_queue.empty() ||
+           sendfile_remaining > 0;
+  }
+
+  // Total bytes queued but not yet handed to the kernel (write buffer,
+  // shared broadcast segments, and pending sendfile) - the occupancy that
+  // backpressure watermarks compare against
+  size_t pendingBytes() const {
+    size_t total = write_buffer.size() + sendfile_remaining;
+    for (const SharedSegment &segment : shared_queue) {
+      total += segment.data->size() - segment.offset;
+    }
+    return total;
+  }
+
+  // Drain the fd until EAGAIN into the pooled read buffer (called on POLLIN)
+  void drainReadBuffer();
+
+  // Route received bytes to onDataChain if set, else onData
+  void deliverData(const BufferView &view);
+
+  // Put the fd into non-blocking mode (required for drain_reads)
+  bool setNonBlocking();
+
+  // TCP_NODELAY: disable Nagle so small responses leave immediately. Safe
+  // to combine with the per-iteration flush coalescing - each iteration's
+  // writes already go out as one writev, so there are no tinygrams for
+  // Nagle to save us from.
+  bool setNoDelay(bool on);
+
+  // TCP_CORK: hold partial frames until uncorked or 200ms pass - the
+  // throughput-over-latency end of the same knob
+  bool setCork(bool on);
+
+  // Schedule this socket for the poller's end-of-iteration flush (called by
+  // the write paths; flushes inline past FLUSH_EAGER_THRESHOLD)
+  void requestFlush();
+
+  // Close the fd, fire onClose, and schedule removal from the poller (the
+  // pool slot is reclaimed on the next loop iteration, so calling this from
+  // inside a data callback is safe)
+  void stop();
+
+  // Async connect internals
+  bool beginConnect(struct sockaddr_in addr);
+  void finishConnect(short revents);
 };
\ No newline at end of file
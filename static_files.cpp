@@ -0,0 +1,105 @@
+#include "static_files.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+StaticFileCache::~StaticFileCache() {
+  for (auto &pair : entries) {
+    if (pair.second.map) {
+      munmap(pair.second.map, pair.second.size);
+    }
+  }
+}
+
+StaticFileCache::Entry *StaticFileCache::lookup(const std::string &fs_path,
+                                                size_t size, time_t mtime) {
+  auto it = entries.find(fs_path);
+  if (it != entries.end()) {
+    if (it->second.mtime == mtime && it->second.size == size) {
+      it->second.last_use = ++use_counter;
+      return &it->second;
+    }
+    dropEntry(fs_path); // file changed on disk - remap below
+  }
+
+  if (size > max_bytes) {
+    return nullptr; // would evict the entire cache for one file
+  }
+  evict(size);
+
+  int fd = open(fs_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if (map == MAP_FAILED) {
+    return nullptr;
+  }
+
+  Entry &entry = entries[fs_path];
+  entry.map = map;
+  entry.size = size;
+  entry.mtime = mtime;
+  entry.last_use = ++use_counter;
+  total_bytes += size;
+  return &entry;
+}
+
+void StaticFileCache::evict(size_t incoming_bytes) {
+  while (total_bytes + incoming_bytes > max_bytes && !entries.empty()) {
+    auto victim = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->second.last_use < victim->second.last_use) {
+        victim = it;
+      }
+    }
+    munmap(victim->second.map, victim->second.size);
+    total_bytes -= victim->second.size;
+    entries.erase(victim);
+  }
+}
+
+void StaticFileCache::dropEntry(const std::string &fs_path) {
+  auto it = entries.find(fs_path);
+  if (it != entries.end()) {
+    munmap(it->second.map, it->second.size);
+    total_bytes -= it->second.size;
+    entries.erase(it);
+  }
+}
+
+const char *staticContentType(const std::string &fs_path) {
+  size_t dot = fs_path.rfind('.');
+  if (dot == std::string::npos) {
+    return "application/octet-stream";
+  }
+  std::string ext = fs_path.substr(dot + 1);
+
+  if (ext == "html" || ext == "htm")
+    return "text/html";
+  if (ext == "css")
+    return "text/css";
+  if (ext == "js")
+    return "application/javascript";
+  if (ext == "json")
+    return "application/json";
+  if (ext == "svg")
+    return "image/svg+xml";
+  if (ext == "png")
+    return "image/png";
+  if (ext == "jpg" || ext == "jpeg")
+    return "image/jpeg";
+  if (ext == "gif")
+    return "image/gif";
+  if (ext == "ico")
+    return "image/x-icon";
+  if (ext == "txt")
+    return "text/plain";
+  if (ext == "wasm")
+    return "application/wasm";
+  if (ext == "woff2")
+    return "font/woff2";
+  return "application/octet-stream";
+}
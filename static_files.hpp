@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+
+// LRU cache of mmap'd static files. Small assets are mapped once and served
+// from the page cache on every hit; each hit revalidates with stat() so an
+// edited file is remapped immediately. Files above sendfile_threshold are
+// not cached at all - they go out through Socket::sendFile so their bytes
+// never transit userspace.
+struct StaticFileCache {
+  struct Entry {
+    void *map = nullptr;
+    size_t size = 0;
+    time_t mtime = 0;
+    uint64_t last_use = 0;
+  };
+
+  size_t max_bytes = 64 * 1024 * 1024; // total mapped-byte budget
+  size_t sendfile_threshold = 256 * 1024;
+
+  std::map<std::string, Entry> entries = {}; // keyed by filesystem path
+  size_t total_bytes = 0;
+  uint64_t use_counter = 0;
+
+  ~StaticFileCache();
+
+  // Mapped entry for the file, (re)mapping and LRU-evicting as needed;
+  // nullptr if the file cannot be opened or mapped
+  Entry *lookup(const std::string &fs_path, size_t size, time_t mtime);
+
+  void evict(size_t incoming_bytes);
+  void dropEntry(const std::string &fs_path);
+};
+
+// Content-Type for a filename based on its extension (fallback
+// application/octet-stream)
+const char *staticContentType(const std::string &fs_path);
@@ -0,0 +1,175 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Hashed hierarchical timer wheel (Varghese/Lauck style) backing the Poller
+// timer API. Insert, cancel and expiry are O(1) amortized instead of the
+// red-black-tree churn of a std::map keyed by TimerID:
+//
+// - level 0: 256 slots of 1ms      (covers the next ~256ms exactly)
+// - level 1:  64 slots of 256ms    (covers ~16s)
+// - level 2:  64 slots of ~16.4s   (covers ~17min)
+// - level 3:  64 slots of ~17.5min (covers ~18h; longer timers are clamped
+//                                   and re-cascade until their real expiry)
+//
+// The wheel only stores (id, expiry_tick) pairs; timer state (callback,
+// interval, ...) stays with the owner. Cancellation is lazy: the owner just
+// forgets the id and the stale pair is skipped when its slot comes up.
+class TimerWheel {
+public:
+  using TimerID = uint32_t;
+  using Tick = uint64_t; // milliseconds since the wheel's origin
+
+private:
+  static constexpr int LEVEL0_BITS = 8;
+  static constexpr int LEVEL_BITS = 6;
+  static constexpr size_t LEVEL0_SIZE = 1 << LEVEL0_BITS;
+  static constexpr size_t LEVEL_SIZE = 1 << LEVEL_BITS;
+
+  // Shift from ticks to slot index per upper level
+  static constexpr int LEVEL1_SHIFT = LEVEL0_BITS;                  // 8
+  static constexpr int LEVEL2_SHIFT = LEVEL0_BITS + LEVEL_BITS;     // 14
+  static constexpr int LEVEL3_SHIFT = LEVEL0_BITS + 2 * LEVEL_BITS; // 20
+  static constexpr Tick MAX_HORIZON = 1ull
+                                      << (LEVEL0_BITS + 3 * LEVEL_BITS); // 26
+
+  struct Entry {
+    TimerID id;
+    Tick expiry;
+  };
+
+  std::array<std::vector<Entry>, LEVEL0_SIZE> level0_ = {};
+  std::array<std::vector<Entry>, LEVEL_SIZE> level1_ = {};
+  std::array<std::vector<Entry>, LEVEL_SIZE> level2_ = {};
+  std::array<std::vector<Entry>, LEVEL_SIZE> level3_ = {};
+
+  Tick current_ = 0;  // last processed tick
+  size_t count_ = 0;  // entries in the wheel (including stale/cancelled ones)
+
+public:
+  bool empty() const { return count_ == 0; }
+  size_t size() const { return count_; }
+  Tick currentTick() const { return current_; }
+
+  void insert(TimerID id, Tick expiry) {
+    // Overdue entries go into the next tick so they fire on the next advance
+    Tick target = expiry > current_ ? expiry : current_ + 1;
+    Tick delta = target - current_;
+
+    if (delta < LEVEL0_SIZE) {
+      level0_[target & (LEVEL0_SIZE - 1)].push_back(Entry{id, expiry});
+    } else if (delta < (1ull << LEVEL2_SHIFT)) {
+      level1_[(target >> LEVEL1_SHIFT) & (LEVEL_SIZE - 1)].push_back(
+          Entry{id, expiry});
+    } else if (delta < (1ull << LEVEL3_SHIFT)) {
+      level2_[(target >> LEVEL2_SHIFT) & (LEVEL_SIZE - 1)].push_back(
+          Entry{id, expiry});
+    } else {
+      // Clamp to the wheel horizon; the entry re-cascades on expiry of the
+      // clamped slot until its real deadline fits into a lower level
+      if (delta >= MAX_HORIZON) {
+        target = current_ + MAX_HORIZON - 1;
+      }
+      level3_[(target >> LEVEL3_SHIFT) & (LEVEL_SIZE - 1)].push_back(
+          Entry{id, expiry});
+    }
+    count_++;
+  }
+
+  // Advance the wheel to now_tick and fire every due entry in one pass.
+  // fire(id, expiry) is called for each; stale entries are the caller's to
+  // detect (id unknown, or expiry not matching its bookkeeping).
+  template <typename FireFn> void advance(Tick now_tick, FireFn &&fire) {
+    if (count_ == 0) {
+      current_ = now_tick; // nothing scheduled - skip the idle period
+      return;
+    }
+
+    std::vector<Entry> due; // reused scratch so callbacks can insert safely
+
+    while (current_ < now_tick) {
+      ++current_;
+
+      // Cascade upper levels down when a lower wheel wraps around
+      if ((current_ & (LEVEL0_SIZE - 1)) == 0) {
+        cascade(level1_[(current_ >> LEVEL1_SHIFT) & (LEVEL_SIZE - 1)]);
+        if ((current_ & ((1ull << LEVEL2_SHIFT) - 1)) == 0) {
+          cascade(level2_[(current_ >> LEVEL2_SHIFT) & (LEVEL_SIZE - 1)]);
+          if ((current_ & ((1ull << LEVEL3_SHIFT) - 1)) == 0) {
+            cascade(level3_[(current_ >> LEVEL3_SHIFT) & (LEVEL_SIZE - 1)]);
+          }
+        }
+      }
+
+      std::vector<Entry> &slot = level0_[current_ & (LEVEL0_SIZE - 1)];
+      if (slot.empty()) {
+        continue;
+      }
+
+      due.clear();
+      due.swap(slot);
+      for (const Entry &entry : due) {
+        count_--;
+        if (entry.expiry <= current_) {
+          fire(entry.id, entry.expiry);
+        } else {
+          insert(entry.id, entry.expiry); // future rotation of this slot
+        }
+      }
+    }
+  }
+
+  // Lower bound in ms until the next entry could fire, capped at max_ms.
+  // Upper-level slots report their slot boundary; waking there cascades and
+  // recomputes, so timers never fire later than their level-0 placement.
+  int msUntilNext(int max_ms) const {
+    if (count_ == 0) {
+      return max_ms;
+    }
+
+    Tick best = static_cast<Tick>(max_ms);
+
+    for (Tick d = 1; d < LEVEL0_SIZE && d < best; ++d) {
+      if (!level0_[(current_ + d) & (LEVEL0_SIZE - 1)].empty()) {
+        best = d;
+        break;
+      }
+    }
+
+    best = scanLevel(level1_, LEVEL1_SHIFT, best);
+    best = scanLevel(level2_, LEVEL2_SHIFT, best);
+    best = scanLevel(level3_, LEVEL3_SHIFT, best);
+
+    return best < 1 ? 1 : static_cast<int>(best);
+  }
+
+private:
+  void cascade(std::vector<Entry> &slot) {
+    if (slot.empty()) {
+      return;
+    }
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    for (const Entry &entry : entries) {
+      count_--;
+      insert(entry.id, entry.expiry);
+    }
+  }
+
+  Tick scanLevel(const std::array<std::vector<Entry>, LEVEL_SIZE> &level,
+                 int shift, Tick best) const {
+    Tick base = current_ >> shift;
+    for (size_t j = 1; j < LEVEL_SIZE; ++j) {
+      Tick slot_start = (base + j) << shift;
+      Tick delta = slot_start - current_;
+      if (delta >= best) {
+        break;
+      }
+      if (!level[(base + j) & (LEVEL_SIZE - 1)].empty()) {
+        return delta;
+      }
+    }
+    return best;
+  }
+};
@@ -0,0 +1,429 @@
+#include "tls_socket.hpp"
+#include "log.hpp"
+#include "poller.hpp"
+#include <openssl/err.h>
+#include <unistd.h>
+
+// ex_data slot carrying the owning TlsContext, so the new-session callback
+// can reach the session cache (app_data carries the Socket)
+static int tlsContextIndex() {
+  static int index =
+      SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return index;
+}
+
+static std::string tlsErrorString() {
+  char buffer[256];
+  ERR_error_string_n(ERR_get_error(), buffer, sizeof(buffer));
+  return std::string(buffer);
+}
+
+// TLS 1.3 delivers the resumption ticket after the handshake, so sessions
+// arrive through this callback rather than at handshake completion. Keep
+// only the newest session per host:port.
+static int tlsNewSessionCallback(SSL *ssl, SSL_SESSION *session) {
+  TlsContext *context =
+      static_cast<TlsContext *>(SSL_get_ex_data(ssl, tlsContextIndex()));
+  Socket *socket = static_cast<Socket *>(SSL_get_app_data(ssl));
+  if (!context || !socket) {
+    return 0; // not ours to keep; OpenSSL frees it
+  }
+  TlsContext::TlsSlot *slot = context->findSlot(*socket);
+  if (!slot || slot->session_key.empty()) {
+    return 0;
+  }
+  auto it = context->session_cache.find(slot->session_key);
+  if (it != context->session_cache.end()) {
+    SSL_SESSION_free(it->second);
+  }
+  context->session_cache[slot->session_key] = session;
+  return 1; // ownership transferred to the cache
+}
+
+static bool applyCommonOptions(SSL_CTX *ctx) {
+  SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+  // Ask the kernel to take over the record layer once the handshake keys
+  // are known; silently ignored when the tls module is unavailable
+  SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+  // Make SSL_write behave like write(2): partial progress is returned and
+  // the retry may pass a different buffer (the Buffer consume cursor moves)
+  SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                            SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+  return true;
+}
+
+bool TlsContext::initServer(const std::string &cert_file,
+                            const std::string &key_file) {
+  ctx = SSL_CTX_new(TLS_server_method());
+  if (!ctx) {
+    LOG_ERROR("[TlsContext] SSL_CTX_new failed: ", tlsErrorString());
+    return false;
+  }
+  is_server = true;
+  applyCommonOptions(ctx);
+
+  // Stateless TLS 1.3 tickets make reconnects cheap without server-side
+  // session storage; the internal cache covers TLS 1.2 session IDs
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+
+  if (SSL_CTX_use_certificate_chain_file(ctx, cert_file.c_str()) != 1) {
+    LOG_ERROR("[TlsContext] Failed to load certificate ", cert_file, ": ",
+              tlsErrorString());
+    return false;
+  }
+  if (SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) !=
+          1 ||
+      SSL_CTX_check_private_key(ctx) != 1) {
+    LOG_ERROR("[TlsContext] Failed to load private key ", key_file, ": ",
+              tlsErrorString());
+    return false;
+  }
+  return true;
+}
+
+bool TlsContext::initClient(bool verify_peer) {
+  ctx = SSL_CTX_new(TLS_client_method());
+  if (!ctx) {
+    LOG_ERROR("[TlsContext] SSL_CTX_new failed: ", tlsErrorString());
+    return false;
+  }
+  is_server = false;
+  applyCommonOptions(ctx);
+
+  if (verify_peer) {
+    SSL_CTX_set_default_verify_paths(ctx);
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+  }
+
+  // Sessions are handed to the new-session callback (no internal store -
+  // the per-host cache here is the store)
+  SSL_CTX_set_session_cache_mode(
+      ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(ctx, tlsNewSessionCallback);
+  return true;
+}
+
+TlsContext::~TlsContext() {
+  for (TlsSlot &slot : slots) {
+    releaseSlot(slot);
+  }
+  for (auto &entry : session_cache) {
+    SSL_SESSION_free(entry.second);
+  }
+  if (ctx) {
+    SSL_CTX_free(ctx);
+  }
+}
+
+TlsContext::TlsSlot &TlsContext::slotFor(Socket &socket) {
+  uint32_t index = pollableSlotIndex(socket.id);
+  while (slots.size() <= index) {
+    slots.emplace_back();
+  }
+  TlsSlot &slot = slots[index];
+  // A previous tenant of this pool slot left its state behind; tear it
+  // down now that the index is being reused
+  if (slot.occupied && slot.owner != socket.id) {
+    releaseSlot(slot);
+  }
+  return slot;
+}
+
+TlsContext::TlsSlot *TlsContext::findSlot(Socket &socket) {
+  uint32_t index = pollableSlotIndex(socket.id);
+  if (index >= slots.size()) {
+    return nullptr;
+  }
+  TlsSlot &slot = slots[index];
+  if (!slot.occupied || slot.owner != socket.id) {
+    return nullptr;
+  }
+  return &slot;
+}
+
+void TlsContext::releaseSlot(TlsSlot &slot) {
+  if (slot.ssl) {
+    SSL_free(slot.ssl); // does not touch the fd (SSL_set_fd, not a BIO own)
+  }
+  slot.ssl = nullptr;
+  slot.occupied = false;
+  slot.owner = 0;
+  slot.handshake_done = false;
+  slot.ktls_offloaded = false;
+  slot.session_key.clear();
+  slot.plain_event = nullptr;
+  slot.on_handshake = nullptr;
+}
+
+bool TlsContext::accept(Socket &socket, HandshakeCallback on_handshake) {
+  if (!ctx || !is_server) {
+    LOG_ERROR("[TlsContext] accept() needs a server context");
+    return false;
+  }
+  return beginHandshake(socket, std::move(on_handshake));
+}
+
+bool TlsContext::connect(Socket &socket, const std::string &host,
+                         uint16_t port, HandshakeCallback on_handshake) {
+  if (!ctx || is_server) {
+    LOG_ERROR("[TlsContext] connect() needs a client context");
+    return false;
+  }
+  if (!socket.start(host, port)) {
+    return false;
+  }
+  if (!beginHandshake(socket, std::move(on_handshake))) {
+    return false;
+  }
+
+  TlsSlot *slot = findSlot(socket);
+  if (slot) {
+    slot->session_key = host + ":" + std::to_string(port);
+    SSL_set_tlsext_host_name(slot->ssl, host.c_str());
+
+    // Offer the newest cached session so the server can resume instead of
+    // running a full handshake
+    auto it = session_cache.find(slot->session_key);
+    if (it != session_cache.end()) {
+      SSL_set_session(slot->ssl, it->second);
+    }
+    continueHandshake(socket, *slot);
+  }
+  return true;
+}
+
+bool TlsContext::beginHandshake(Socket &socket,
+                                HandshakeCallback on_handshake) {
+  TlsSlot &slot = slotFor(socket);
+  slot.ssl = SSL_new(ctx);
+  if (!slot.ssl) {
+    LOG_ERROR("[TlsContext] SSL_new failed: ", tlsErrorString());
+    return false;
+  }
+  SSL_set_fd(slot.ssl, socket.file_descriptor);
+  if (is_server) {
+    SSL_set_accept_state(slot.ssl);
+  } else {
+    SSL_set_connect_state(slot.ssl);
+  }
+  SSL_set_app_data(slot.ssl, &socket);
+  SSL_set_ex_data(slot.ssl, tlsContextIndex(), this);
+
+  slot.owner = socket.id;
+  slot.occupied = true;
+  slot.handshake_done = false;
+  slot.on_handshake = std::move(on_handshake);
+
+  // Take over the socket's event handling for the handshake (and, without
+  // kTLS, for the lifetime of the connection); the plain handler is saved
+  // so the offloaded case can restore the untouched fast paths
+  slot.plain_event = socket.onEvent;
+  socket.onEvent = [this, &socket](short revents) {
+    driveEvent(socket, revents);
+  };
+
+  if (is_server) {
+    continueHandshake(socket, slot);
+  }
+  return true;
+}
+
+bool TlsContext::isOffloaded(Socket &socket) {
+  TlsSlot *slot = findSlot(socket);
+  return slot && slot->ktls_offloaded;
+}
+
+void TlsContext::driveEvent(Socket &socket, short revents) {
+  TlsSlot *slot = findSlot(socket);
+  if (!slot || socket.file_descriptor < 0) {
+    return;
+  }
+  if (!slot->handshake_done) {
+    continueHandshake(socket, *slot);
+    return;
+  }
+
+  // Software record layer (the kTLS case restored the plain handler and
+  // never gets here)
+  if (revents & POLLIN) {
+    drainReads(socket, *slot);
+    if (socket.file_descriptor < 0) {
+      return;
+    }
+  }
+  if ((revents & POLLOUT) && socket.wantsPollout()) {
+    size_t before_flush = socket.pendingBytes();
+    flushWrites(socket, *slot);
+    if (socket.file_descriptor < 0) {
+      return;
+    }
+    if (socket.close_after_flush && !socket.wantsPollout()) {
+      socket.stop();
+    } else if (socket.onDrain && before_flush > socket.drain_threshold &&
+               socket.pendingBytes() <= socket.drain_threshold) {
+      socket.onDrain(socket);
+    }
+  }
+}
+
+void TlsContext::continueHandshake(Socket &socket, TlsSlot &slot) {
+  int result = SSL_do_handshake(slot.ssl);
+  if (result == 1) {
+    finishHandshake(socket, slot);
+    return;
+  }
+
+  int error = SSL_get_error(slot.ssl, result);
+  switch (error) {
+  case SSL_ERROR_WANT_READ:
+    return; // POLLIN is always armed; the next chunk resumes the handshake
+  case SSL_ERROR_WANT_WRITE:
+    if (socket.poller) {
+      socket.poller->enablePollout(socket.id);
+    }
+    return;
+  default:
+    LOG_ERROR("[TlsContext] Handshake failed with ", socket.remote_addr, ": ",
+              tlsErrorString());
+    failHandshake(socket, slot);
+    return;
+  }
+}
+
+void TlsContext::finishHandshake(Socket &socket, TlsSlot &slot) {
+  slot.handshake_done = true;
+
+  // If the kernel took both directions of the record layer, hand the socket
+  // back its plain event handler - writev, drain reads, and sendfile all
+  // operate on the encrypted fd from here on
+  bool ktls_tx = BIO_get_ktls_send(SSL_get_wbio(slot.ssl)) > 0;
+  bool ktls_rx = BIO_get_ktls_recv(SSL_get_rbio(slot.ssl)) > 0;
+  if (ktls_tx && ktls_rx) {
+    slot.ktls_offloaded = true;
+    socket.onEvent = slot.plain_event;
+  }
+
+  LOG("[TlsContext] ", SSL_get_version(slot.ssl), " handshake with ",
+      socket.remote_addr, SSL_session_reused(slot.ssl) ? " (resumed)" : "",
+      slot.ktls_offloaded ? ", kTLS offloaded" : ", software record layer");
+
+  if (slot.on_handshake) {
+    slot.on_handshake(socket, true);
+  }
+  // Writes queued while the handshake was in flight go out now
+  if (socket.poller && socket.wantsPollout()) {
+    socket.poller->enablePollout(socket.id);
+  }
+}
+
+void TlsContext::failHandshake(Socket &socket, TlsSlot &slot) {
+  HandshakeCallback callback = std::move(slot.on_handshake);
+  socket.onEvent = slot.plain_event; // stop() paths expect the plain handler
+  releaseSlot(slot);
+  if (callback) {
+    callback(socket, false);
+  }
+  socket.stop();
+}
+
+void TlsContext::drainReads(Socket &socket, TlsSlot &slot) {
+  char buffer[16 * 1024];
+  for (;;) {
+    int bytes_read = SSL_read(slot.ssl, buffer, sizeof(buffer));
+    if (bytes_read > 0) {
+      if (socket.poller) {
+        socket.poller->metrics.countBytesRead(bytes_read);
+      }
+      BufferView view{buffer, static_cast<size_t>(bytes_read)};
+      socket.deliverData(view);
+      if (socket.file_descriptor < 0) {
+        return; // a data callback closed the connection
+      }
+      continue;
+    }
+
+    int error = SSL_get_error(slot.ssl, bytes_read);
+    switch (error) {
+    case SSL_ERROR_WANT_READ:
+      return; // decrypted everything available
+    case SSL_ERROR_WANT_WRITE:
+      if (socket.poller) {
+        socket.poller->enablePollout(socket.id);
+      }
+      return;
+    case SSL_ERROR_ZERO_RETURN: // clean close_notify
+    default:
+      socket.stop();
+      return;
+    }
+  }
+}
+
+void TlsContext::flushWrites(Socket &socket, TlsSlot &slot) {
+  // Shared broadcast segments can't ride an SSL_write scatter-gather; fold
+  // them into the write buffer so ordering holds
+  if (!socket.shared_queue.empty()) {
+    socket.materializeSharedQueue();
+  }
+
+  while (socket.write_buffer.size() > 0) {
+    Buffer::Slice slice = socket.write_buffer.sliceAt(0);
+    int written = SSL_write(slot.ssl, slice.data, slice.size);
+    if (written > 0) {
+      if (socket.poller) {
+        socket.poller->metrics.countBytesWritten(written);
+      }
+      socket.write_buffer.consume(static_cast<size_t>(written));
+      continue;
+    }
+    int error = SSL_get_error(slot.ssl, written);
+    if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+      if (socket.poller) {
+        socket.poller->enablePollout(socket.id);
+      }
+      return;
+    }
+    socket.stop();
+    return;
+  }
+
+  // sendfile fallback: without kTLS the file bytes have to pass through
+  // the record layer, so read-and-encrypt in chunks (the offloaded case
+  // keeps the true zero-copy sendfile path)
+  while (socket.sendfile_remaining > 0 && socket.write_buffer.size() == 0) {
+    char chunk[16 * 1024];
+    size_t want = socket.sendfile_remaining < sizeof(chunk)
+                      ? socket.sendfile_remaining
+                      : sizeof(chunk);
+    ssize_t got =
+        pread(socket.sendfile_fd, chunk, want, socket.sendfile_offset);
+    if (got <= 0) {
+      close(socket.sendfile_fd); // truncated or unreadable; drop the rest
+      socket.sendfile_fd = -1;
+      socket.sendfile_remaining = 0;
+      return;
+    }
+    int written = SSL_write(slot.ssl, chunk, static_cast<int>(got));
+    if (written > 0) {
+      if (socket.poller) {
+        socket.poller->metrics.countBytesWritten(written);
+      }
+      socket.sendfile_offset += written;
+      socket.sendfile_remaining -= static_cast<size_t>(written);
+      if (socket.sendfile_remaining == 0) {
+        close(socket.sendfile_fd);
+        socket.sendfile_fd = -1;
+      }
+      continue;
+    }
+    int error = SSL_get_error(slot.ssl, written);
+    if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+      if (socket.poller) {
+        socket.poller->enablePollout(socket.id);
+      }
+      return;
+    }
+    socket.stop();
+    return;
+  }
+}
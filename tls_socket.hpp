@@ -0,0 +1,93 @@
+#pragma once
+
+#include "pollable.hpp"
+#include "socket.hpp"
+#include <functional>
+#include <map>
+#include <openssl/ssl.h>
+#include <string>
+#include <vector>
+
+// Async TLS on top of the existing Socket machinery. A TlsContext wraps one
+// SSL_CTX (server or client role) and drives the handshake for any number of
+// sockets by swapping each socket's onEvent handler, the same state-behind-
+// the-pollable pattern WebSocketServer uses - pool sockets cannot be
+// subclassed, so per-connection TLS state lives in a slab keyed by the
+// socket's pool index with the generation-carrying ID guarding against
+// recycled slots.
+//
+// The handshake is fully non-blocking: SSL_WANT_READ rides the always-armed
+// POLLIN, SSL_WANT_WRITE arms POLLOUT for one wakeup. Once it completes the
+// context asks OpenSSL whether the kernel took over the record layer
+// (SSL_OP_ENABLE_KTLS): with kTLS active in both directions the socket's
+// plain event handler is restored and every existing fast path -
+// scatter-gather writev, zero-copy sendfile, drain-mode reads - runs
+// unchanged on the encrypted fd. Without kTLS a software path encrypts
+// write_buffer slices through SSL_write and decrypts into the normal
+// onData/onDataChain delivery, including a read-and-encrypt fallback for
+// queued sendfile transfers.
+//
+// Resumption: the server side issues stateless TLS 1.3 tickets (OpenSSL
+// default); the client side caches the newest session per host:port and
+// offers it on the next connect, so reconnects skip the certificate
+// exchange and a round trip.
+struct TlsContext {
+  SSL_CTX *ctx = nullptr;
+  bool is_server = false;
+
+  using HandshakeCallback = std::function<void(Socket &, bool ok)>;
+
+  // Per-socket TLS state, slab-indexed like WebSocketServer's connection
+  // slots. A slot whose owner ID no longer matches is stale and is torn
+  // down when the slot index is reused.
+  struct TlsSlot {
+    PollableID owner = 0;
+    bool occupied = false;
+    SSL *ssl = nullptr;
+    bool handshake_done = false;
+    bool ktls_offloaded = false;
+    std::string session_key = ""; // host:port, client resumption cache key
+    Pollable::EventCallback plain_event = nullptr;
+    HandshakeCallback on_handshake = nullptr;
+  };
+  std::vector<TlsSlot> slots = {};
+
+  // Newest session per host:port, offered on the next client connect
+  std::map<std::string, SSL_SESSION *> session_cache = {};
+
+  // Server role: load the PEM certificate chain and private key
+  bool initServer(const std::string &cert_file, const std::string &key_file);
+
+  // Client role. Peer verification is off by default so self-signed
+  // development certificates work; pass true to verify against the
+  // system trust store.
+  bool initClient(bool verify_peer = false);
+
+  // Server side: start the TLS handshake on a freshly accepted socket
+  // (call from Listener::onAccept). The callback fires on the poller
+  // thread once the handshake settles; wire onData/onDataChain there.
+  bool accept(Socket &socket, HandshakeCallback on_handshake);
+
+  // Client side: TCP connect (same blocking establish as Socket::start),
+  // then handshake asynchronously, offering a cached session if one exists
+  bool connect(Socket &socket, const std::string &host, uint16_t port,
+               HandshakeCallback on_handshake);
+
+  // Whether the kernel is doing the record layer for this socket (the
+  // writev/sendfile fast paths are live)
+  bool isOffloaded(Socket &socket);
+
+  ~TlsContext();
+
+  // Internal: slab access and the event pump
+  TlsSlot &slotFor(Socket &socket);
+  TlsSlot *findSlot(Socket &socket);
+  void releaseSlot(TlsSlot &slot);
+  bool beginHandshake(Socket &socket, HandshakeCallback on_handshake);
+  void driveEvent(Socket &socket, short revents);
+  void continueHandshake(Socket &socket, TlsSlot &slot);
+  void finishHandshake(Socket &socket, TlsSlot &slot);
+  void failHandshake(Socket &socket, TlsSlot &slot);
+  void drainReads(Socket &socket, TlsSlot &slot);
+  void flushWrites(Socket &socket, TlsSlot &slot);
+};
@@ -0,0 +1,131 @@
+#include "warm_restart.hpp"
+#include "log.hpp"
+#include "poller.hpp"
+#include <charconv>
+
+bool WarmRestart::serveHandoff(Poller &poller, const std::string &control_path,
+                               Vector<Listener *> listeners,
+                               std::function<void()> on_handoff) {
+  this->poller = &poller;
+  this->pending = std::move(listeners);
+  this->on_handoff = std::move(on_handoff);
+
+  handoff_listener = poller.createListener();
+  if (!handoff_listener->startUnix(control_path)) {
+    LOG_ERROR("[WarmRestart] Failed to bind handoff channel at ",
+              control_path);
+    return false;
+  }
+
+  handoff_listener->onAccept = [this](Socket *socket) {
+    sendListeners(*socket);
+  };
+  return true;
+}
+
+void WarmRestart::sendListeners(Socket &socket) {
+  String manifest = "ports:";
+  Vector<int> fds;
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (i > 0) {
+      manifest += ",";
+    }
+    manifest += std::to_string(pending[i]->port).c_str();
+    fds.push_back(pending[i]->file_descriptor);
+  }
+  manifest += "\n";
+
+  // One sendmsg carries every fd and the manifest it describes; a fresh
+  // accepted socket has nothing queued, so sendFds cannot refuse
+  if (!socket.sendFds(fds.data(), fds.size(), manifest.data(),
+                      manifest.size())) {
+    LOG_ERROR("[WarmRestart] Failed to send listener fds");
+    socket.stop();
+    return;
+  }
+
+  LOG("[WarmRestart] Handed off ", fds.size(), " listener fd(s)");
+  socket.stop(); // the bytes and fds are already in the peer's buffer
+
+  if (on_handoff) {
+    on_handoff();
+  }
+}
+
+bool WarmRestart::requestHandoff(Poller &poller,
+                                 const std::string &control_path,
+                                 AdoptCallback on_adopted) {
+  this->poller = &poller;
+  this->on_adopted = std::move(on_adopted);
+
+  Socket *socket = poller.createSocket();
+  if (!socket->startUnix(control_path)) {
+    // No incumbent serving the channel - this is a cold start
+    socket->stop();
+    return false;
+  }
+
+  socket->onFdReceived = [this](Socket &, int fd) {
+    received_fds.push_back(fd);
+  };
+  socket->onData = [this](Socket &sock, const BufferView &view) {
+    manifest.append(view.data, view.size);
+    if (manifest.find('\n') != String::npos) {
+      adoptListeners(sock);
+    }
+  };
+  return true;
+}
+
+void WarmRestart::adoptListeners(Socket &socket) {
+  // Manifest: "ports:8080,8443\n", one entry per fd, in send order. The
+  // control socket sits at a well-known path, so treat the manifest as
+  // untrusted wire input: parse without exceptions and abort the handoff
+  // on anything that isn't a plain in-range port list.
+  Vector<uint16_t> ports;
+  bool manifest_ok = manifest.rfind("ports:", 0) == 0;
+  size_t start = manifest.find(':') + 1;
+  size_t end = manifest.find('\n');
+  while (manifest_ok && start < end) {
+    size_t comma = manifest.find(',', start);
+    if (comma == String::npos || comma > end) {
+      comma = end;
+    }
+    uint16_t port = 0;
+    const char *first = manifest.data() + start;
+    const char *last = manifest.data() + comma;
+    auto [ptr, ec] = std::from_chars(first, last, port);
+    if (ec != std::errc() || ptr != last) {
+      manifest_ok = false;
+      break;
+    }
+    ports.push_back(port);
+    start = comma + 1;
+  }
+
+  if (!manifest_ok || ports.size() != received_fds.size()) {
+    LOG_ERROR("[WarmRestart] Unusable handoff manifest (", ports.size(),
+              " ports parsed, ", received_fds.size(),
+              " fds arrived); aborting handoff");
+    for (int fd : received_fds) {
+      close(fd);
+    }
+    received_fds.clear();
+    socket.stop();
+    return;
+  }
+
+  Vector<Listener *> adopted;
+  for (size_t i = 0; i < ports.size(); i++) {
+    Listener *listener = poller->createListener();
+    listener->adopt(received_fds[i], ports[i]);
+    adopted.push_back(listener);
+    LOG("[WarmRestart] Adopted listener on port ", ports[i]);
+  }
+  received_fds.clear();
+  socket.stop();
+
+  if (on_adopted) {
+    on_adopted(adopted);
+  }
+}
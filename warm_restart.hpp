@@ -0,0 +1,67 @@
+#pragma once
+
+#include "containers.hpp"
+#include "listener.hpp"
+#include "socket.hpp"
+#include <functional>
+
+struct Poller;
+
+// Zero-downtime restart: the running process hands its listening sockets to
+// a freshly exec'd instance over a unix domain socket (SCM_RIGHTS), so the
+// listen queue - and every connection parked in it - survives the deploy.
+// The old process keeps serving its established connections and drains at
+// its own pace; the new one accepts from the shared queue the moment
+// adoption completes, so clients never see a closed port or reconnect storm.
+//
+// Old instance:
+//   WarmRestart warm;
+//   warm.serveHandoff(poller, "/tmp/app-handoff.sock", {listener},
+//                     [&]() { /* stop accepting, drain, exit */ });
+//
+// New instance (before cold-starting its own listeners):
+//   if (!warm.requestHandoff(poller, "/tmp/app-handoff.sock",
+//                            [&](Vector<Listener *> &adopted) { ... }))
+//     { /* no incumbent - bind fresh */ }
+//
+// The wire format is one sendmsg carrying every listener fd plus a text
+// manifest of their ports ("ports:8080,8443\n"). Established connections
+// can ride the same kind of channel with app-serialized state via
+// Socket::sendFds / Socket::onFdReceived - the transport is generic; only
+// the listener manifest is interpreted here.
+struct WarmRestart {
+  Poller *poller = nullptr;
+
+  // Old side: the AF_UNIX control listener and what it will hand over
+  Listener *handoff_listener = nullptr;
+  Vector<Listener *> pending = {};
+  std::function<void()> on_handoff = nullptr;
+
+  // New side: fds and manifest bytes accumulated from the incumbent
+  using AdoptCallback = std::function<void(Vector<Listener *> &)>;
+  AdoptCallback on_adopted = nullptr;
+  Vector<int> received_fds = {};
+  String manifest = "";
+
+  // Old side: publish the handoff channel at `control_path`. When the new
+  // instance connects, every listener's fd is sent in a single message and
+  // on_handoff fires - the moment to stop accepting and start draining.
+  // The listeners stay open here; closing them later doesn't disturb the
+  // shared listen queue, which the adopting process keeps alive.
+  bool serveHandoff(Poller &poller, const std::string &control_path,
+                    Vector<Listener *> listeners,
+                    std::function<void()> on_handoff = nullptr);
+
+  // New side: connect to the incumbent's handoff channel and adopt its
+  // listeners. Returns false when no incumbent is serving at control_path
+  // (first boot after a crash, say) - bind fresh listeners instead.
+  // on_adopted runs on the poller thread with the adopted listeners, fds
+  // armed and accepting; install onAccept handlers there.
+  bool requestHandoff(Poller &poller, const std::string &control_path,
+                      AdoptCallback on_adopted);
+
+  // Internal: send the fds + manifest down an accepted control connection
+  void sendListeners(Socket &socket);
+  // Internal: manifest complete - build Listener objects around the fds
+  void adoptListeners(Socket &socket);
+};
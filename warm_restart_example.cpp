@@ -0,0 +1,76 @@
+#include "http_server.hpp"
+#include "log.hpp"
+#include "poller.hpp"
+#include "warm_restart.hpp"
+#include <unistd.h>
+
+// Zero-downtime restart example
+//
+// Terminal 1 - start the first instance:
+//   ./warm_restart_example
+// Terminal 2 - take over without dropping the port:
+//   ./warm_restart_example takeover
+//
+// The second instance adopts the first one's listening socket over
+// /tmp/warm_restart_example.sock: connections parked in the listen queue
+// during the switch are accepted by the new process, the old one stops
+// accepting and drains. `curl http://localhost:8080/pid` before and after
+// shows the serving pid change with no refused connections in between.
+
+static const char *kHandoffPath = "/tmp/warm_restart_example.sock";
+
+static void addRoutes(HttpServer &server) {
+  server.get("/pid", [](HttpRequest &, HttpResponse &response) {
+    response.body = "served by pid " + std::to_string(getpid()) + "\n";
+  });
+}
+
+int main(int argc, char **argv) {
+  bool takeover = argc > 1 && std::string(argv[1]) == "takeover";
+
+  Poller poller;
+  WarmRestart warm;
+  HttpServer *server = nullptr;
+
+  if (takeover) {
+    bool adopted_ok = warm.requestHandoff(
+        poller, kHandoffPath, [&](Vector<Listener *> &adopted) {
+          Listener *listener = adopted[0];
+          server = new HttpServer(listener);
+          addRoutes(*server);
+          // Become the incumbent for the next deploy
+          warm.serveHandoff(poller, kHandoffPath, {listener},
+                            [&, listener]() {
+                              LOG("Handed off; draining and exiting");
+                              listener->stop();
+                              poller.setTimeout(2000,
+                                                [&]() { poller.stop(); });
+                            });
+          LOG("Takeover complete - serving on the adopted listener, pid ",
+              getpid());
+        });
+    if (!adopted_ok) {
+      LOG_ERROR("No incumbent to take over from - start without arguments");
+      return 1;
+    }
+  } else {
+    Listener *listener = poller.createListener();
+    if (!listener->start(8080)) {
+      LOG_ERROR("Failed to listen on port 8080");
+      return 1;
+    }
+    server = new HttpServer(listener);
+    addRoutes(*server);
+
+    warm.serveHandoff(poller, kHandoffPath, {listener}, [&, listener]() {
+      LOG("Handed off; draining and exiting");
+      listener->stop();
+      poller.setTimeout(2000, [&]() { poller.stop(); });
+    });
+    LOG("Serving on port 8080, pid ", getpid());
+  }
+
+  poller.start();
+  delete server;
+  return 0;
+}
@@ -1,6 +1,7 @@
 #include "websocket_client.hpp"
 #include "log.hpp"
 #include "poller.hpp"
+#include "ws_unmask.hpp"
 #include <algorithm>
 #include <cstring>
 #include <iostream>
@@ -223,17 +224,28 @@ void WebSocketClient::handleSocketData(const BufferView &data) {
     LOG("[WebSocket] Handshake successful, connection is now OPEN");
   } else if (status == WebSocketStatus::OPEN) {
     LOG("[WebSocket] Processing WebSocket frame");
-    // Handle WebSocket frames
-    std::vector<uint8_t> frame_data(data.data, data.data + data.size);
-    parseFrame(frame_data);
+    // Accumulate: a frame can span several reads (large payloads) and a
+    // read can carry several frames (server write coalescing)
+    rx_buffer.insert(rx_buffer.end(), data.data, data.data + data.size);
+    while (!rx_buffer.empty()) {
+      size_t consumed = parseFrame(rx_buffer);
+      if (consumed == 0) {
+        break; // incomplete frame - wait for more data
+      }
+      rx_buffer.erase(rx_buffer.begin(), rx_buffer.begin() + consumed);
+      if (status != WebSocketStatus::OPEN) {
+        rx_buffer.clear(); // CLOSE frame handled - drop anything trailing
+        break;
+      }
+    }
   }
 }
 
-void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
+size_t WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
   LOG("[WebSocket] parseFrame: Starting to parse frame with ", data.size(), " bytes");
   if (data.size() < 2) {
-    LOG_ERROR("[WebSocket] parseFrame: data.size() < 2");
-    return;
+    LOG("[WebSocket] parseFrame: waiting for frame header");
+    return 0;
   }
 
   WebSocketFrame frame;
@@ -259,8 +271,8 @@ void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
   if (payload_len == 126) {
     LOG("[WebSocket] parseFrame: Using 16-bit extended payload length");
     if (data.size() < offset + 2) {
-      LOG_ERROR("[WebSocket] parseFrame: Early return - insufficient data for 16-bit payload length (need ", offset + 2, ", have ", data.size(), ")");
-      return;
+      LOG("[WebSocket] parseFrame: waiting for 16-bit payload length (need ", offset + 2, ", have ", data.size(), ")");
+      return 0;
     }
     frame.payload_length = (data[offset] << 8) | data[offset + 1];
     LOG("[WebSocket] parseFrame: Extended payload length (16-bit): ", frame.payload_length);
@@ -268,8 +280,8 @@ void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
   } else if (payload_len == 127) {
     LOG("[WebSocket] parseFrame: Using 64-bit extended payload length");
     if (data.size() < offset + 8) {
-      LOG_ERROR("[WebSocket] parseFrame: Early return - insufficient data for 64-bit payload length (need ", offset + 8, ", have ", data.size(), ")");
-      return;
+      LOG("[WebSocket] parseFrame: waiting for 64-bit payload length (need ", offset + 8, ", have ", data.size(), ")");
+      return 0;
     }
     frame.payload_length = 0;
     for (int i = 0; i < 8; ++i) {
@@ -286,8 +298,8 @@ void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
   if (frame.masked) {
     LOG("[WebSocket] parseFrame: Frame is masked, parsing masking key");
     if (data.size() < offset + 4) {
-      LOG_ERROR("[WebSocket] parseFrame: Early return - insufficient data for masking key (need ", offset + 4, ", have ", data.size(), ")");
-      return;
+      LOG("[WebSocket] parseFrame: waiting for masking key (need ", offset + 4, ", have ", data.size(), ")");
+      return 0;
     }
     frame.masking_key = (data[offset] << 24) | (data[offset + 1] << 16) |
                         (data[offset + 2] << 8) | data[offset + 3];
@@ -300,17 +312,15 @@ void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
   // Parse payload
   LOG("[WebSocket] parseFrame: Checking payload size - need ", offset + frame.payload_length, " bytes, have ", data.size());
   if (data.size() < offset + frame.payload_length) {
-    LOG_ERROR("[WebSocket] parseFrame: Early return - insufficient data for payload (need ", offset + frame.payload_length, ", have ", data.size(), ")");
-    return;
+    LOG("[WebSocket] parseFrame: waiting for payload (need ", offset + frame.payload_length, ", have ", data.size(), ")");
+    return 0;
   }
 
   LOG("[WebSocket] parseFrame: Parsing payload of ", frame.payload_length, " bytes");
   frame.payload.resize(frame.payload_length);
-  for (size_t i = 0; i < frame.payload_length; ++i) {
-    frame.payload[i] = data[offset + i];
-    if (frame.masked) {
-      frame.payload[i] ^= ((frame.masking_key >> ((3 - (i % 4)) * 8)) & 0xFF);
-    }
+  memcpy(frame.payload.data(), data.data() + offset, frame.payload_length);
+  if (frame.masked) {
+    wsUnmask(frame.payload.data(), frame.payload_length, frame.masking_key);
   }
   if (frame.masked) {
     LOG("[WebSocket] parseFrame: Payload unmasked successfully");
@@ -368,6 +378,7 @@ void WebSocketClient::parseFrame(const std::vector<uint8_t> &data) {
     break;
   }
   LOG("[WebSocket] parseFrame: Frame processing completed");
+  return offset + frame.payload_length;
 }
 
 std::vector<uint8_t> WebSocketClient::buildFrame(const std::string &message,
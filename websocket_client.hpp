@@ -38,6 +38,11 @@ struct WebSocketClient {
   std::string protocol = "";
   std::string key = "";
 
+  // Frames can arrive split across socket reads (large payloads) or several
+  // per read (server write coalescing) - bytes accumulate here until a
+  // complete frame can be consumed
+  std::vector<uint8_t> rx_buffer = {};
+
   using MessageCallback = std::function<void(const std::string &)>;
   using BinaryCallback = std::function<void(const std::vector<uint8_t> &)>;
   using OpenCallback = std::function<void()>;
@@ -66,7 +71,9 @@ struct WebSocketClient {
   std::string buildHandshakeRequest();
   bool parseHandshakeResponse(const std::string &data);
   void handleSocketData(const BufferView &data);
-  void parseFrame(const std::vector<uint8_t> &data);
+  // Parses one frame from the front of data; returns bytes consumed,
+  // 0 when the frame is still incomplete
+  size_t parseFrame(const std::vector<uint8_t> &data);
   std::vector<uint8_t>
   buildFrame(const std::string &message,
              WebSocketOpcode opcode = WebSocketOpcode::TEXT);
@@ -106,8 +106,6 @@ int main(int argc, char *argv[]) {
           waiting_for_response = true;
           message_timer.reset();
           std::string msg = "Message #" + std::to_string(messages_sent);
-          client->sendText(msg);
-
           client->sendText(msg);
           LOG("📊 sendText: ", msg);
 
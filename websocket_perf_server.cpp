@@ -0,0 +1,35 @@
+#include "websocket_perf_server.hpp"
+#include "listener.hpp"
+#include "log.hpp"
+#include "websocket_server.hpp"
+
+bool startWebSocketPerfServer(Poller &poller, uint16_t port) {
+  Listener *listener = poller.createListener();
+  if (!listener || !listener->start(port)) {
+    LOG_ERROR("Failed to listen on port ", port);
+    return false;
+  }
+
+  // Process-lifetime by design: the suite runs scenarios until the poller
+  // stops and then exits, so there is nothing to tear down
+  WebSocketServer *server = new WebSocketServer(listener);
+
+  server->route("/echo", [](WebSocketConnection &conn) {
+    conn.onMessage = [](WebSocketConnection &connection,
+                        const String &message) {
+      connection.sendText(message);
+    };
+    conn.onBinary = [](WebSocketConnection &connection,
+                       const Vector<uint8_t> &data) {
+      connection.sendBinary(data);
+    };
+  });
+
+  server->route("/bcast", [server](WebSocketConnection &conn) {
+    conn.onMessage = [server](WebSocketConnection &, const String &message) {
+      server->broadcast("/bcast", message);
+    };
+  });
+
+  return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "poller.hpp"
+#include <cstdint>
+
+// In-process server half of websocket_perf_test. Lives in its own
+// translation unit because websocket_server.hpp and websocket_client.hpp
+// each define the frame types and cannot be included together; the suite's
+// main file only sees this declaration.
+//
+// Routes: /echo (echoes text and binary back) and /bcast (fans every
+// message out to all /bcast connections). Returns false when the port is
+// already taken. The server lives for the rest of the process.
+bool startWebSocketPerfServer(Poller &poller, uint16_t port);
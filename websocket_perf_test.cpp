@@ -1,169 +1,429 @@
-#include "websocket_client.hpp"
-#include "poller.hpp"
+// WebSocket regression benchmark suite.
+//
+// Self-hosting: one process runs the WebSocketServer and all clients on a
+// single poller, so a run needs no external server and produces comparable
+// numbers across machines. The suite sweeps scenarios - message sizes times
+// text/binary framing in echo mode, plus server-side fan-out via broadcast -
+// and reports a latency histogram (p50/p90/p99/p999) and throughput per
+// scenario as machine-readable JSON. Client-to-server frames are always
+// masked (RFC 6455 requires it of clients), so every scenario exercises the
+// server's unmask path.
+//
+//   websocket_perf_test [-c connections] [-n messages_per_conn]
+//                       [-s size,size,...] [-m echo,broadcast]
+//                       [-k text,binary] [-p port] [-o out.json]
+//                       [-b baseline.json] [-t threshold]
+//
+// Baseline mode (-b) compares each scenario's p99 against the same scenario
+// in a previous run's JSON and exits non-zero when one regresses by more
+// than the threshold (default 0.25 = 25%) - the gate for WebSocket-path
+// changes: run once on the base commit with -o, once on the change with -b.
+
+#include "bench_histogram.hpp"
 #include "log.hpp"
-#include <chrono>
-#include <iostream>
-#include <thread>
-#include <atomic>
+#include "poller.hpp"
+#include "steady_clock.hpp"
+#include "websocket_client.hpp"
+#include "websocket_perf_server.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <vector>
 
-struct PerfStats {
-    std::atomic<int> messages_sent{0};
-    std::atomic<int> messages_received{0};
-    std::atomic<long long> total_latency_us{0};
-    std::chrono::steady_clock::time_point start_time;
-    std::chrono::steady_clock::time_point end_time;
+namespace {
+
+struct Scenario {
+  std::string mode = "echo"; // "echo" or "broadcast"
+  std::string kind = "text"; // "text" or "binary"
+  size_t size = 64;
+  size_t messages = 0; // per connection (echo) / rounds (broadcast)
+
+  std::string name() const {
+    return mode + "-" + kind + "-" + std::to_string(size);
+  }
 };
 
-int main(int argc, char* argv[]) {
-    if (argc < 4) {
-        std::cout << "Usage: " << argv[0] << " <server_url> <num_messages> <concurrent_clients>" << std::endl;
-        std::cout << "Example: " << argv[0] << " ws://localhost:8765/echo 1000 10" << std::endl;
-        return 1;
-    }
+struct SuiteConfig {
+  size_t connections = 50;
+  size_t messages = 200;
+  uint16_t port = 9777;
+  std::vector<size_t> sizes = {64, 1024, 65536};
+  std::vector<std::string> modes = {"echo", "broadcast"};
+  std::vector<std::string> kinds = {"text", "binary"};
+  std::string out_path = "";
+  std::string baseline_path = "";
+  double threshold = 0.25;
+};
+
+struct ScenarioResult {
+  Scenario scenario = {};
+  uint64_t received = 0;
+  double elapsed_s = 0;
+  uint64_t mean_us = 0, p50_us = 0, p90_us = 0, p99_us = 0, p999_us = 0,
+           max_us = 0;
+};
+
+struct SuiteRunner {
+  Poller &poller;
+  SuiteConfig cfg;
+  std::vector<Scenario> scenarios = {};
+  std::vector<ScenarioResult> results = {};
+  size_t current = 0;
+
+  // Per-scenario state
+  std::vector<WebSocketClient *> clients = {};
+  std::vector<SteadyClock::TimePoint> sent_at = {};
+  std::vector<size_t> sent_count = {};
+  std::vector<uint8_t> payload_bin = {};
+  std::string payload = "";
+  BenchHistogram hist = {};
+  SteadyClock::TimePoint scenario_start = {};
+  SteadyClock::TimePoint round_sent_at = {};
+  size_t open_count = 0, done_count = 0, closed_count = 0;
+  size_t bcast_rounds = 0, bcast_round_received = 0;
+  uint64_t received_total = 0;
+  bool tearing_down = false;
+  bool advanced = false;
 
-    std::string server_url = argv[1];
-    int num_messages = std::stoi(argv[2]);
-    int concurrent_clients = std::stoi(argv[3]);
-
-    LOG("WebSocket Performance Test");
-    LOG("==========================");
-    LOG("Server: ", server_url);
-    LOG("Messages per client: ", num_messages);
-    LOG("Concurrent clients: ", concurrent_clients);
-    LOG("Total messages: ", num_messages * concurrent_clients);
-
-    Poller poller;
-    PerfStats stats;
-    std::atomic<int> clients_connected{0};
-    std::atomic<int> clients_finished{0};
-    
-    std::vector<WebSocketClient*> clients;
-    std::vector<std::chrono::steady_clock::time_point> send_times(num_messages);
-
-    // Create clients
-    for (int i = 0; i < concurrent_clients; i++) {
-        WebSocketClient* client = WebSocketClient::fromSocket(poller.createSocket());
-        if (!client) {
-            LOG_ERROR("Failed to create client ", i);
-            continue;
+  SuiteRunner(Poller &poller, SuiteConfig cfg)
+      : poller(poller), cfg(std::move(cfg)) {}
+
+  void buildScenarios() {
+    for (const std::string &mode : cfg.modes) {
+      for (size_t size : cfg.sizes) {
+        // Scale message count down for large payloads so every scenario
+        // moves a comparable byte volume instead of taking minutes
+        size_t messages =
+            size <= 4096
+                ? cfg.messages
+                : std::max<size_t>(10, cfg.messages * 4096 / size);
+        if (mode == "echo") {
+          for (const std::string &kind : cfg.kinds) {
+            scenarios.push_back(Scenario{mode, kind, size, messages});
+          }
+        } else {
+          // Fan-out cost is framing-independent; text keeps it one scenario
+          scenarios.push_back(Scenario{mode, "text", size, messages});
         }
+      }
+    }
+  }
+
+  void startScenario() {
+    const Scenario &sc = scenarios[current];
+    LOG("scenario ", sc.name(), ": ", cfg.connections, " connections, ",
+        sc.messages, sc.mode == "echo" ? " msgs/conn" : " rounds");
+
+    clients.assign(cfg.connections, nullptr);
+    sent_at.assign(cfg.connections, SteadyClock::TimePoint{});
+    sent_count.assign(cfg.connections, 0);
+    payload.assign(sc.size, 'x');
+    payload_bin.assign(sc.size, 0x7f);
+    hist.reset();
+    open_count = done_count = closed_count = 0;
+    bcast_rounds = bcast_round_received = 0;
+    received_total = 0;
+    tearing_down = false;
+    advanced = false;
 
-        clients.push_back(client);
-
-        // Set up handlers for each client
-        client->onOpen = [&stats, &clients_connected, concurrent_clients]() {
-            clients_connected++;
-            if (clients_connected == concurrent_clients) {
-                LOG("All ", concurrent_clients, " clients connected. Starting test...");
-                stats.start_time = std::chrono::steady_clock::now();
-            }
-        };
-
-        client->onMessage = [&stats, &send_times, num_messages](const std::string& message) {
-            stats.messages_received++;
-            
-            // Extract message ID to calculate latency
-            if (message.find("Echo: Message ") == 0) {
-                size_t start_pos = message.find("Message ") + 8;
-                size_t end_pos = message.find(" ", start_pos);
-                if (end_pos != std::string::npos) {
-                    int msg_id = std::stoi(message.substr(start_pos, end_pos - start_pos));
-                    if (msg_id >= 0 && msg_id < num_messages) {
-                        auto now = std::chrono::steady_clock::now();
-                        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
-                            now - send_times[msg_id]).count();
-                        stats.total_latency_us += latency;
-                    }
-                }
-            }
-        };
-
-        client->onError = [i](const std::string& error) {
-            LOG_ERROR("Client ", i, " error: ", error);
-        };
-
-        client->onClose = [&clients_finished, &stats, concurrent_clients](uint16_t code, const std::string& reason) {
-            clients_finished++;
-            if (clients_finished == concurrent_clients) {
-                stats.end_time = std::chrono::steady_clock::now();
-                LOG("All clients finished");
-            }
-        };
-
-        // Connect client
-        if (!client->connect(server_url)) {
-            LOG_ERROR("Failed to connect client ", i);
+    const char *path = sc.mode == "echo" ? "/echo" : "/bcast";
+    std::string url = "ws://127.0.0.1:" + std::to_string(cfg.port) + path;
+
+    for (size_t i = 0; i < cfg.connections; i++) {
+      WebSocketClient *client =
+          WebSocketClient::fromSocket(poller.createSocket());
+      clients[i] = client;
+
+      client->onOpen = [this]() {
+        open_count++;
+        if (open_count == cfg.connections) {
+          scenario_start = SteadyClock::now();
+          beginTraffic();
+        }
+      };
+      client->onMessage = [this, i](const std::string &) { onReceipt(i); };
+      client->onBinary = [this, i](const std::vector<uint8_t> &) {
+        onReceipt(i);
+      };
+      client->onError = [](const std::string &error) {
+        LOG_ERROR("client error: ", error);
+      };
+      client->onClose = [this, i](uint16_t, const std::string &) {
+        if (!tearing_down) {
+          LOG_ERROR("client ", i, " closed mid-scenario");
+          return;
         }
+        closed_count++;
+        if (closed_count >= cfg.connections) {
+          nextScenario();
+        }
+      };
+
+      if (!client->connect(url)) {
+        LOG_ERROR("connect failed for client ", i);
+      }
+    }
+  }
+
+  void beginTraffic() {
+    if (scenarios[current].mode == "echo") {
+      for (size_t i = 0; i < cfg.connections; i++) {
+        sendOne(i);
+      }
+    } else {
+      sendRound();
     }
+  }
 
-    // Wait for all clients to connect
-    while (clients_connected < concurrent_clients) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  void sendOne(size_t i) {
+    sent_at[i] = SteadyClock::now();
+    sent_count[i]++;
+    if (scenarios[current].kind == "binary") {
+      clients[i]->sendBinary(payload_bin);
+    } else {
+      clients[i]->sendText(payload);
     }
+  }
+
+  void sendRound() {
+    bcast_round_received = 0;
+    round_sent_at = SteadyClock::now();
+    clients[0]->sendText(payload);
+  }
 
-    // Send messages from all clients
-    poller.setTimeout(1000, [&]() {
-        for (int msg = 0; msg < num_messages; msg++) {
-            send_times[msg] = std::chrono::steady_clock::now();
-            
-            for (auto* client : clients) {
-                if (client->status == WebSocketStatus::OPEN) {
-                    std::string message = "Message " + std::to_string(msg) + " from client";
-                    client->sendText(message);
-                    stats.messages_sent++;
-                }
-            }
-            
-            // Small delay between message batches to avoid overwhelming
-            if (msg % 100 == 0 && msg > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
+  void onReceipt(size_t i) {
+    if (tearing_down) {
+      return;
+    }
+    const Scenario &sc = scenarios[current];
+    received_total++;
+
+    if (sc.mode == "echo") {
+      hist.record(elapsedUs(sent_at[i]));
+      if (sent_count[i] < sc.messages) {
+        sendOne(i);
+      } else {
+        done_count++;
+        if (done_count == cfg.connections) {
+          finishScenario();
+        }
+      }
+    } else {
+      hist.record(elapsedUs(round_sent_at));
+      bcast_round_received++;
+      if (bcast_round_received == cfg.connections) {
+        bcast_rounds++;
+        if (bcast_rounds < sc.messages) {
+          sendRound();
+        } else {
+          finishScenario();
         }
+      }
+    }
+  }
+
+  void finishScenario() {
+    ScenarioResult result;
+    result.scenario = scenarios[current];
+    result.received = received_total;
+    result.elapsed_s = elapsedUs(scenario_start) / 1e6;
+    result.mean_us = hist.count ? hist.sum_us / hist.count : 0;
+    result.p50_us = hist.percentileUs(0.50);
+    result.p90_us = hist.percentileUs(0.90);
+    result.p99_us = hist.percentileUs(0.99);
+    result.p999_us = hist.percentileUs(0.999);
+    result.max_us = hist.max_us;
+    results.push_back(result);
 
-        // Close all clients after sending
-        poller.setTimeout(2000, [&]() {
-            for (auto* client : clients) {
-                if (client->status == WebSocketStatus::OPEN) {
-                    client->close(1000, "Test complete");
-                }
-            }
-        });
-    });
-
-    // Start poller
-    poller.start();
-
-    // Wait for test completion
-    while (clients_finished < concurrent_clients) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    LOG("  ", received_total, " msgs in ", result.elapsed_s, "s  p50=",
+        result.p50_us, "us p99=", result.p99_us, "us");
+
+    tearing_down = true;
+    for (WebSocketClient *client : clients) {
+      if (client->status == WebSocketStatus::OPEN) {
+        client->close(1000, "scenario done");
+      } else {
+        closed_count++; // already gone (error path)
+      }
+    }
+    if (closed_count >= cfg.connections) {
+      nextScenario();
     }
+  }
 
-    poller.stop();
-
-    // Calculate and display results
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        stats.end_time - stats.start_time).count();
-    
-    double throughput = (double)stats.messages_received / (duration / 1000.0);
-    double avg_latency = stats.messages_received > 0 ? 
-        (double)stats.total_latency_us / stats.messages_received / 1000.0 : 0;
-
-    LOG("");
-    LOG("Performance Results:");
-    LOG("===================");
-    LOG("Messages sent: ", stats.messages_sent.load());
-    LOG("Messages received: ", stats.messages_received.load());
-    LOG("Test duration: ", duration, " ms");
-    LOG("Throughput: ", (int)throughput, " messages/second");
-    LOG("Average latency: ", avg_latency, " ms");
-    LOG("Message loss: ", stats.messages_sent - stats.messages_received, 
-        " (", (double)(stats.messages_sent - stats.messages_received) / stats.messages_sent * 100, "%)");
-
-    // Cleanup
-    for (auto* client : clients) {
-        delete client;
+  // Close callbacks can run synchronously inside close(), so both the last
+  // onClose and finishScenario's fallback may land here - advance once
+  void nextScenario() {
+    if (advanced) {
+      return;
+    }
+    advanced = true;
+    current++;
+    if (current >= scenarios.size()) {
+      poller.stop();
+      return;
     }
+    // Small gap so the previous scenario's close frames fully drain
+    poller.setTimeout(100, [this]() { startScenario(); });
+  }
+
+  static uint64_t elapsedUs(SteadyClock::TimePoint since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               SteadyClock::now() - since)
+        .count();
+  }
+};
+
+std::string renderJson(const SuiteConfig &cfg,
+                       const std::vector<ScenarioResult> &results) {
+  std::ostringstream out;
+  out << "{\"connections\":" << cfg.connections << ",\"results\":[";
+  for (size_t i = 0; i < results.size(); i++) {
+    const ScenarioResult &r = results[i];
+    double rate = r.elapsed_s > 0 ? r.received / r.elapsed_s : 0;
+    if (i) {
+      out << ",";
+    }
+    out << "{\"scenario\":\"" << r.scenario.name() << "\""
+        << ",\"mode\":\"" << r.scenario.mode << "\""
+        << ",\"kind\":\"" << r.scenario.kind << "\""
+        << ",\"size\":" << r.scenario.size << ",\"messages\":" << r.received
+        << ",\"throughput_msg_s\":" << static_cast<uint64_t>(rate)
+        << ",\"mean_us\":" << r.mean_us << ",\"p50_us\":" << r.p50_us
+        << ",\"p90_us\":" << r.p90_us << ",\"p99_us\":" << r.p99_us
+        << ",\"p999_us\":" << r.p999_us << ",\"max_us\":" << r.max_us << "}";
+  }
+  out << "]}\n";
+  return out.str();
+}
+
+// Pull "p99_us":<n> for the named scenario out of a previous run's JSON.
+// The file is our own flat format, so a string scan beats pulling a JSON
+// dependency into the tree.
+bool baselineP99(const std::string &baseline, const std::string &name,
+                 uint64_t *p99) {
+  size_t at = baseline.find("\"scenario\":\"" + name + "\"");
+  if (at == std::string::npos) {
+    return false;
+  }
+  size_t key = baseline.find("\"p99_us\":", at);
+  if (key == std::string::npos) {
+    return false;
+  }
+  *p99 = std::strtoull(baseline.c_str() + key + 9, nullptr, 10);
+  return true;
+}
+
+void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-c connections] [-n messages_per_conn]\n"
+          "       [-s size,size,...] [-m echo,broadcast] [-k text,binary]\n"
+          "       [-p port] [-o out.json] [-b baseline.json] [-t threshold]\n",
+          prog);
+}
 
-    return 0;
-}
\ No newline at end of file
+std::vector<std::string> splitList(const char *arg) {
+  std::vector<std::string> items;
+  std::istringstream in(arg);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    items.push_back(item);
+  }
+  return items;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  SuiteConfig cfg;
+
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "-c") == 0 && arg + 1 < argc) {
+      cfg.connections = std::strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc) {
+      cfg.messages = std::strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "-p") == 0 && arg + 1 < argc) {
+      cfg.port = std::strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "-s") == 0 && arg + 1 < argc) {
+      cfg.sizes.clear();
+      for (const std::string &item : splitList(argv[++arg])) {
+        cfg.sizes.push_back(std::strtoul(item.c_str(), nullptr, 10));
+      }
+    } else if (strcmp(argv[arg], "-m") == 0 && arg + 1 < argc) {
+      cfg.modes = splitList(argv[++arg]);
+    } else if (strcmp(argv[arg], "-k") == 0 && arg + 1 < argc) {
+      cfg.kinds = splitList(argv[++arg]);
+    } else if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc) {
+      cfg.out_path = argv[++arg];
+    } else if (strcmp(argv[arg], "-b") == 0 && arg + 1 < argc) {
+      cfg.baseline_path = argv[++arg];
+    } else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc) {
+      cfg.threshold = std::atof(argv[++arg]);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (cfg.connections == 0 || cfg.messages == 0 || cfg.sizes.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  Poller poller;
+  if (!startWebSocketPerfServer(poller, cfg.port)) {
+    return 1;
+  }
+
+  SuiteRunner runner(poller, cfg);
+  runner.buildScenarios();
+  runner.startScenario();
+  poller.start(); // blocks until the last scenario stops the loop
+
+  std::string json = renderJson(cfg, runner.results);
+  fputs(json.c_str(), stdout);
+  if (!cfg.out_path.empty()) {
+    std::ofstream out(cfg.out_path);
+    out << json;
+  }
+
+  // Baseline gate: fail the run when a scenario's p99 regressed
+  if (!cfg.baseline_path.empty()) {
+    std::ifstream in(cfg.baseline_path);
+    if (!in) {
+      fprintf(stderr, "cannot read baseline %s\n", cfg.baseline_path.c_str());
+      return 2;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string baseline = buffer.str();
+
+    bool failed = false;
+    for (const ScenarioResult &r : runner.results) {
+      uint64_t base_p99 = 0;
+      if (!baselineP99(baseline, r.scenario.name(), &base_p99)) {
+        fprintf(stderr, "baseline missing scenario %s (skipped)\n",
+                r.scenario.name().c_str());
+        continue;
+      }
+      double limit = base_p99 * (1.0 + cfg.threshold);
+      if (r.p99_us > limit) {
+        fprintf(stderr, "REGRESSION %s: p99 %llu us vs baseline %llu us "
+                        "(+%.0f%% > %.0f%% threshold)\n",
+                r.scenario.name().c_str(),
+                static_cast<unsigned long long>(r.p99_us),
+                static_cast<unsigned long long>(base_p99),
+                (static_cast<double>(r.p99_us) / base_p99 - 1.0) * 100,
+                cfg.threshold * 100);
+        failed = true;
+      }
+    }
+    if (failed) {
+      return 1;
+    }
+    fprintf(stderr, "all scenarios within %.0f%% of baseline p99\n",
+            cfg.threshold * 100);
+  }
+  return 0;
+}
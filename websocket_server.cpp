@@ -3,9 +3,14 @@
 #include "http_server.hpp"
 #include "log.hpp"
 #include "poller.hpp"
+#if USE_AREA_ALLOCATORS
+#include "poller_memory.hpp"
+#endif
+#include "ws_unmask.hpp"
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <openssl/sha.h>
 #include <random>
 
@@ -39,15 +44,131 @@ void WebSocketServer::route(const String &path,
   routes[path] = handler;
 }
 
+void WebSocketServer::broadcast(const String &path, const String &message) {
+  // Serialize once; every subscriber shares the same refcounted bytes and
+  // tracks its own partial-send offset in the socket's shared queue
+  Vector<uint8_t> frame =
+      WebSocketConnection::buildFrame(message, WebSocketOpcode::TEXT);
+  auto shared = std::make_shared<const std::string>(
+      reinterpret_cast<const char *>(frame.data()), frame.size());
+
+  for (ConnectionSlot &slot : connection_slots) {
+    WebSocketConnection &conn = slot.conn;
+    if (!slot.occupied || conn.status != WebSocketConnectionStatus::OPEN) {
+      continue;
+    }
+    if (!path.empty() && conn.path != path) {
+      continue;
+    }
+    conn.socket->writeShared(shared);
+  }
+}
+
+void WebSocketServer::enableHeartbeat(uint32_t interval_ms,
+                                      uint32_t max_missed) {
+  heartbeat_max_missed = max_missed;
+
+  // Serialize the ping once; every sweep queues the same refcounted bytes
+  // on every socket (same mechanism as broadcast)
+  if (!heartbeat_ping) {
+    Vector<uint8_t> frame =
+        WebSocketConnection::buildFrame(String(), WebSocketOpcode::PING);
+    heartbeat_ping = std::make_shared<const std::string>(
+        reinterpret_cast<const char *>(frame.data()), frame.size());
+  }
+
+  Poller *poller = listener ? listener->poller : nullptr;
+  if (!poller) {
+    LOG_ERROR("[WebSocketServer] Cannot enable heartbeat without a poller");
+    return;
+  }
+  if (heartbeat_timer != 0) {
+    poller->clearInterval(heartbeat_timer);
+  }
+  heartbeat_timer =
+      poller->setInterval(interval_ms, [this]() { sweepHeartbeats(); });
+}
+
+void WebSocketServer::sweepHeartbeats() {
+  heartbeat_epoch++;
+
+  // Stale peers are collected first and torn down after the sweep - their
+  // close callbacks vacate slab slots mid-iteration otherwise
+  Vector<Socket *> stale;
+  for (ConnectionSlot &slot : connection_slots) {
+    WebSocketConnection &conn = slot.conn;
+    if (!slot.occupied || conn.status != WebSocketConnectionStatus::OPEN) {
+      continue;
+    }
+    if (conn.missed_pongs >= heartbeat_max_missed) {
+      stale.push_back(conn.socket);
+      continue;
+    }
+    conn.missed_pongs++;
+    conn.ping_epoch = heartbeat_epoch;
+    conn.socket->writeShared(heartbeat_ping);
+  }
+
+  for (Socket *socket : stale) {
+    WebSocketConnection *conn = findConnection(*socket);
+    if (!conn) {
+      continue;
+    }
+    LOG("[WebSocketServer] Closing unresponsive connection on ", conn->path);
+    conn->close(1001, "heartbeat timeout");
+    // The peer is presumed gone; don't wait for the close handshake
+    socket->close_after_flush = true;
+    if (!socket->wantsPollout()) {
+      socket->stop();
+    }
+  }
+}
+
 WebSocketConnection &WebSocketServer::createConnection(Socket &socket) {
-  // LOG("[WebSocketServer] Creating new WebSocket connection for socket at ",
-  //     socket.remote_addr, ":", socket.remote_port);
+#if USE_AREA_ALLOCATORS
+  // Slot state outlives any single message, so it must never capture the
+  // frame-area context an upgrade request happens to be parsed under
+  AreaAllocatorContext slot_context(nullptr);
+#endif
+  // Slots are addressed by the socket's pool index, so the slab grows to
+  // the poller's high-water connection count and then stops allocating;
+  // a recycled slot is reset in place with its buffer capacity intact
+  uint32_t index = pollableSlotIndex(socket.id);
+  while (connection_slots.size() <= index) {
+    connection_slots.emplace_back();
+  }
 
-  // Create a new connection and store it in the connections map
-  connections[&socket] = WebSocketConnection();
-  WebSocketConnection &conn = connections[&socket];
+  ConnectionSlot &slot = connection_slots[index];
+  slot.conn.reset();
+  slot.conn.socket = &socket;
+  slot.owner = socket.id;
+  slot.occupied = true;
+  connection_count++;
+  return slot.conn;
+}
+
+WebSocketConnection *WebSocketServer::findConnection(Socket &socket) {
+  uint32_t index = pollableSlotIndex(socket.id);
+  if (index >= connection_slots.size()) {
+    return nullptr;
+  }
+  ConnectionSlot &slot = connection_slots[index];
+  // The owner ID carries the generation bits, so a connection left over
+  // from a previous tenant of the socket slot never matches
+  if (!slot.occupied || slot.owner != socket.id) {
+    return nullptr;
+  }
+  return &slot.conn;
+}
 
-  return conn;
+void WebSocketServer::releaseConnection(Socket &socket) {
+  WebSocketConnection *conn = findConnection(socket);
+  if (!conn) {
+    return;
+  }
+  conn->reset(); // drop per-connection state now, keep the capacity
+  connection_slots[pollableSlotIndex(socket.id)].occupied = false;
+  connection_count--;
 }
 
 void WebSocketServer::handleConnection(Socket &socket) {
@@ -57,30 +178,37 @@ void WebSocketServer::handleConnection(Socket &socket) {
   createConnection(socket);
 
   LOG("[WebSocketServer] Connection stored, total connections: ",
-      connections.size());
+      connection_count);
 
-  socket.onData = [this, &socket](Socket &sock, const BufferView &data) {
-    LOG("[WebSocketServer] Received ", data.size, " bytes from ",
+  attachDataHandler(socket);
+}
+
+void WebSocketServer::attachDataHandler(Socket &socket) {
+  socket.onDataChain = [this](Socket &sock, const BufferChain &data) {
+    LOG("[WebSocketServer] Received ", data.size(), " bytes from ",
         sock.remote_addr);
 
-    auto it = connections.find(&socket);
-    if (it == connections.end()) {
+    WebSocketConnection *conn = findConnection(sock);
+    if (!conn) {
       LOG_ERROR("[WebSocketServer] Connection not found for socket");
       return;
     }
 
-    WebSocketConnection &conn = it->second;
-
-    if (conn.status == WebSocketConnectionStatus::OPEN) {
-      conn.handleSocketData(data);
+    if (conn->status == WebSocketConnectionStatus::OPEN) {
+      // Frames are parsed straight off the chain - no intermediate copy
+      conn->handleSocketData(data);
     } else {
-      // Handle HTTP upgrade request
-      String data_str(
-          data.data,
-          data.size); // MEMORY ALLOCATION: string copy of incoming data
-      // OPTIMIZATION STRATEGY: Use string_view to avoid copy, parse directly
-      // from BufferView
-      this->handleHttpRequest(sock, data_str, &conn);
+#if USE_AREA_ALLOCATORS
+      // Upgrade parsing is message-scoped work too - header temporaries
+      // come from a frame area reclaimed when the handshake is done
+      FrameAreaScope upgrade_area;
+#endif
+      // Handle HTTP upgrade request; the header parser still wants flat
+      // bytes, so this one path flattens into the connection's reused
+      // scratch string rather than a fresh allocation
+      conn->message_scratch.clear();
+      data.appendTo(conn->message_scratch);
+      this->handleHttpRequest(sock, conn->message_scratch, conn);
     }
   };
 }
@@ -225,7 +353,8 @@ String WebSocketServer::generateAcceptKey(const String &key) {
   return result;
 }
 
-String WebSocketServer::buildHandshakeResponse(const String &accept_key) {
+String WebSocketServer::buildHandshakeResponse(const String &accept_key,
+                                               const String &extensions) {
   StringStream ss; // MEMORY ALLOCATION: stringstream for response building
   // OPTIMIZATION STRATEGY: Use pre-allocated response buffer template,
   // sprintf-style formatting
@@ -233,8 +362,40 @@ String WebSocketServer::buildHandshakeResponse(const String &accept_key) {
   ss << "Upgrade: websocket\r\n";
   ss << "Connection: Upgrade\r\n";
   ss << "Sec-WebSocket-Accept: " << accept_key << "\r\n";
+  ss << extensions;
   ss << "\r\n";
-  return ss.str();
+  std::string flat = ss.str();
+  return String(flat.data(), flat.size());
+}
+
+String WebSocketServer::negotiateExtensions(const String &offer,
+                                            WebSocketConnection *conn) {
+  if (!permessage_deflate ||
+      offer.find("permessage-deflate") == String::npos) {
+    return "";
+  }
+
+  auto ctx = std::make_shared<WsDeflateContext>();
+  ctx->enabled = true;
+  // Honor the client's takeover requests, and impose our own when the
+  // server is configured to bound per-connection window memory
+  ctx->server_no_context_takeover =
+      no_context_takeover ||
+      offer.find("server_no_context_takeover") != String::npos;
+  ctx->client_no_context_takeover =
+      no_context_takeover ||
+      offer.find("client_no_context_takeover") != String::npos;
+  conn->deflate = ctx;
+
+  String line = "Sec-WebSocket-Extensions: permessage-deflate";
+  if (ctx->server_no_context_takeover) {
+    line += "; server_no_context_takeover";
+  }
+  if (ctx->client_no_context_takeover) {
+    line += "; client_no_context_takeover";
+  }
+  line += "\r\n";
+  return line;
 }
 
 void WebSocketServer::upgradeToWebSocket(Socket &socket, const String &path,
@@ -247,21 +408,101 @@ void WebSocketServer::upgradeToWebSocket(Socket &socket, const String &path,
     return;
   }
 
-  String accept_key = generateAcceptKey(
-      key_it->second); // MEMORY ALLOCATION: string for accept key
+  conn->headers = headers; // MEMORY ALLOCATION: map copy for headers storage
+
+  auto ext_it = headers.find("sec-websocket-extensions");
+  completeUpgrade(socket, path, key_it->second,
+                  ext_it != headers.end() ? ext_it->second : String(), conn);
+}
+
+void WebSocketServer::adoptUpgrade(Socket &socket,
+                                   const HttpRequest &request) {
+  WebSocketConnection *conn = &createConnection(socket);
+  attachDataHandler(socket);
+
+  const std::string *key = request.headers.find("Sec-WebSocket-Key");
+  if (!key) {
+    LOG_ERROR("[WebSocketServer] Missing Sec-WebSocket-Key header");
+    socket.write("HTTP/1.1 400 Bad Request\r\n\r\n");
+    return;
+  }
+
+  // Keep the connection's header copy in the lowercase-keyed form the
+  // raw-listener parse path produces, so handler code reading
+  // conn.headers behaves the same on either path
+  for (const auto &header : request.headers) {
+    String name(header.name.data(), header.name.size());
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    conn->headers[name] = String(header.value.data(), header.value.size());
+  }
+
+  const std::string *ext = request.headers.find("Sec-WebSocket-Extensions");
+  completeUpgrade(socket, String(request.path.data(), request.path.size()),
+                  String(key->data(), key->size()),
+                  ext ? String(ext->data(), ext->size()) : String(), conn);
+}
+
+void WebSocketServer::completeUpgrade(Socket &socket, const String &path,
+                                      const String &key,
+                                      const String &ext_offer,
+                                      WebSocketConnection *conn) {
+  String accept_key =
+      generateAcceptKey(key); // MEMORY ALLOCATION: string for accept key
+
+  // permessage-deflate negotiation happens before the response goes out
+  String extensions = "";
+  if (!ext_offer.empty()) {
+    extensions = negotiateExtensions(ext_offer, conn);
+  }
+
   String response = buildHandshakeResponse(
-      accept_key); // MEMORY ALLOCATION: string for handshake response
+      accept_key, extensions); // MEMORY ALLOCATION: string for handshake
+                               // response
   // OPTIMIZATION STRATEGY: Generate response directly to socket buffer, avoid
   // intermediate strings
 
   LOG("[WebSocketServer] Sending handshake response");
-  socket.write(response);
+  socket.write(response.data(), response.size());
 
   // Set up WebSocket connection
   conn->socket = &socket;
   conn->status = WebSocketConnectionStatus::OPEN;
-  conn->path = path;       // MEMORY ALLOCATION: string copy for path storage
-  conn->headers = headers; // MEMORY ALLOCATION: map copy for headers storage
+  conn->path = path; // MEMORY ALLOCATION: string copy for path storage
+
+  attachOpenHandlers(socket, conn);
+
+  LOG("[WebSocketServer] WebSocket connection established for path: ", path);
+  onConnection(*conn);
+
+  // Call route handler if exists
+  auto route_it = routes.find(path);
+  if (route_it != routes.end()) {
+    route_it->second(*conn);
+  }
+}
+
+void WebSocketServer::attachOpenHandlers(Socket &socket,
+                                         WebSocketConnection *conn) {
+  // Backpressure: when the write path falls back below the low watermark,
+  // flush parked messages first and then tell the producer it may resume
+  socket.drain_threshold = conn->low_watermark;
+  socket.onDrain = [conn](Socket &) {
+    conn->flushOverflow();
+    if (conn->overflow.empty() && conn->onDrain) {
+      conn->onDrain(*conn);
+    }
+  };
+
+  // Drop the connection entry when the socket goes away (peer hangup or a
+  // stalled client getting reaped) so the map and parked messages don't
+  // outlive the transport
+  socket.onClose = [this, conn](Socket &closed) {
+    if (conn->status != WebSocketConnectionStatus::CLOSED) {
+      conn->status = WebSocketConnectionStatus::CLOSED;
+      onDisconnection(*conn);
+    }
+    releaseConnection(closed);
+  };
   // OPTIMIZATION STRATEGY: Store only essential headers (key, protocol), use
   // string_view for path
 
@@ -275,7 +516,7 @@ void WebSocketServer::upgradeToWebSocket(Socket &socket, const String &path,
   };
 
   conn->onBinary = [this, conn](WebSocketConnection &connection,
-                                const std::vector<uint8_t> &data) {
+                                const Vector<uint8_t> &data) {
     auto route_it = routes.find(connection.path);
     if (route_it != routes.end()) {
       route_it->second(connection);
@@ -283,60 +524,163 @@ void WebSocketServer::upgradeToWebSocket(Socket &socket, const String &path,
   };
 
   conn->onClose = [this](WebSocketConnection &connection, uint16_t code,
-                         const std::string &reason) {
+                         const String &reason) {
     LOG("[WebSocketServer] Connection closed: ", code, " - ", reason);
     onDisconnection(connection);
   };
 
   conn->onError = [this](WebSocketConnection &connection,
-                         const std::string &error) {
+                         const String &error) {
     LOG_ERROR("[WebSocketServer] Connection error: ", error);
   };
+}
 
-  LOG("[WebSocketServer] WebSocket connection established for path: ", path);
-  onConnection(*conn);
-
-  // Call route handler if exists
-  auto route_it = routes.find(path);
-  if (route_it != routes.end()) {
-    route_it->second(*conn);
+bool WebSocketServer::migrateConnection(WebSocketConnection &conn,
+                                        Poller &target,
+                                        WebSocketServer &target_server) {
+  Socket *socket = conn.socket;
+  if (!socket || !socket->poller ||
+      conn.status != WebSocketConnectionStatus::OPEN) {
+    return false;
   }
+  Poller *source = socket->poller;
+
+  // Lift the state out of its slot before the socket (whose ID the slot's
+  // owner check is keyed on) goes away; the vacated slot recycles in place
+  auto state = std::make_shared<WebSocketConnection>(std::move(conn));
+  releaseConnection(*socket);
+
+  WebSocketServer *dest = &target_server;
+  return source->migrate(socket->id, target, [state, dest](Socket &fresh) {
+    WebSocketConnection &adopted = dest->createConnection(fresh);
+    adopted = std::move(*state);
+    adopted.socket = &fresh;
+    // Heartbeat epochs are per-server counters; start clean under the
+    // adopting server's sweep
+    adopted.ping_epoch = dest->heartbeat_epoch;
+    adopted.missed_pongs = 0;
+    dest->attachDataHandler(fresh);
+    dest->attachOpenHandlers(fresh, &adopted);
+    auto route_it = dest->routes.find(adopted.path);
+    if (route_it != dest->routes.end()) {
+      route_it->second(adopted);
+    }
+  });
 }
 
 // WebSocketConnection methods
-void WebSocketConnection::sendText(const std::string &message) {
+bool WebSocketConnection::sendText(const String &message) {
   if (status != WebSocketConnectionStatus::OPEN) {
     onError(*this, "WebSocket connection is not open");
-    return;
+    return false;
   }
 
-  std::vector<uint8_t> frame = buildFrame(
-      message,
-      WebSocketOpcode::TEXT); // MEMORY ALLOCATION: vector for frame data
-  Buffer buffer;              // MEMORY ALLOCATION: Buffer object
-  // OPTIMIZATION STRATEGY: Use thread-local frame buffer pool, write directly
-  // to socket buffer
-  buffer.append(reinterpret_cast<const char *>(frame.data()), frame.size());
-  socket->write(buffer);
+  Vector<uint8_t> frame;
+  // Compressed messages carry RSV1; a failed compress falls back to plain
+  Vector<uint8_t> compressed;
+  if (deflate && deflate->enabled && !message.empty() &&
+      deflate->compress(reinterpret_cast<const uint8_t *>(message.data()),
+                        message.size(), compressed)) {
+    frame = buildFrame(compressed, WebSocketOpcode::TEXT, true);
+  } else {
+    frame = buildFrame(message, WebSocketOpcode::TEXT);
+  }
+  return queueFrame(std::move(frame));
 }
 
-void WebSocketConnection::sendBinary(const std::vector<uint8_t> &data) {
+bool WebSocketConnection::sendBinary(const Vector<uint8_t> &data) {
   if (status != WebSocketConnectionStatus::OPEN) {
     onError(*this, "WebSocket connection is not open");
-    return;
+    return false;
   }
 
-  std::vector<uint8_t> frame = buildFrame(
-      data,
-      WebSocketOpcode::BINARY); // MEMORY ALLOCATION: vector for frame data
-  Buffer buffer;                // MEMORY ALLOCATION: Buffer object
-  // OPTIMIZATION STRATEGY: Use thread-local frame buffer pool, avoid vector
-  // allocation per message
-  buffer.append(reinterpret_cast<const char *>(frame.data()), frame.size());
-  socket->write(buffer);
+  Vector<uint8_t> frame;
+  Vector<uint8_t> compressed;
+  if (deflate && deflate->enabled && !data.empty() &&
+      deflate->compress(data.data(), data.size(), compressed)) {
+    frame = buildFrame(compressed, WebSocketOpcode::BINARY, true);
+  } else {
+    frame = buildFrame(data, WebSocketOpcode::BINARY);
+  }
+  return queueFrame(std::move(frame));
+}
+
+void WebSocketConnection::reset() {
+  socket = nullptr;
+  status = WebSocketConnectionStatus::CONNECTING;
+  path.clear();
+  headers.clear();
+  frame_carry.clear();
+  frame_scratch.payload.clear();
+  message_scratch.clear();
+  deflate = nullptr;
+  inflate_scratch.clear();
+  high_watermark = 1024 * 1024;
+  low_watermark = 256 * 1024;
+  drop_oldest = false;
+  dropped_messages = 0;
+  overflow.clear();
+  overflow_bytes = 0;
+  ping_epoch = 0;
+  missed_pongs = 0;
+  onDrain = nullptr;
+  onMessage = [](WebSocketConnection &, const String &) {};
+  onBinary = [](WebSocketConnection &, const Vector<uint8_t> &) {};
+  onClose = [](WebSocketConnection &, uint16_t, const String &) {};
+  onError = [](WebSocketConnection &, const String &) {};
+}
+
+bool WebSocketConnection::queueFrame(Vector<uint8_t> frame) {
+  // Applications adjust the watermarks from onConnection, after the upgrade
+  // wired the socket - re-sync the drain threshold on every send so the
+  // crossing check always compares against the current low mark
+  socket->drain_threshold = low_watermark;
+
+  // Messages park in the overflow queue once the socket is saturated (or
+  // while earlier parked messages exist, to preserve order)
+  if (!overflow.empty() && socket->pendingBytes() < high_watermark) {
+    flushOverflow(); // capacity came back; move parked messages out first
+  }
+  if (!overflow.empty() || socket->pendingBytes() >= high_watermark) {
+    overflow_bytes += frame.size();
+#if USE_AREA_ALLOCATORS
+    // The frame was likely built under a frame-area context that ends when
+    // this message is done; a parked copy must own heap memory instead
+    overflow.emplace_back(frame.begin(), frame.end(),
+                          AreaAllocator<uint8_t>(nullptr));
+#else
+    overflow.push_back(std::move(frame));
+#endif
+    if (drop_oldest) {
+      // Keep the freshest messages; a stalled consumer loses the oldest
+      while (overflow.size() > 1 && overflow_bytes > high_watermark) {
+        overflow_bytes -= overflow.front().size();
+        overflow.pop_front();
+        dropped_messages++;
+      }
+    }
+    return false;
+  }
+
+  socket->write(reinterpret_cast<const char *>(frame.data()), frame.size());
+  return socket->pendingBytes() < high_watermark;
+}
+
+void WebSocketConnection::flushOverflow() {
+  if (status != WebSocketConnectionStatus::OPEN) {
+    overflow.clear();
+    overflow_bytes = 0;
+    return;
+  }
+  while (!overflow.empty() && socket->pendingBytes() < high_watermark) {
+    Vector<uint8_t> &frame = overflow.front();
+    socket->write(reinterpret_cast<const char *>(frame.data()), frame.size());
+    overflow_bytes -= frame.size();
+    overflow.pop_front();
+  }
 }
 
-void WebSocketConnection::close(uint16_t code, const std::string &reason) {
+void WebSocketConnection::close(uint16_t code, const String &reason) {
   if (status == WebSocketConnectionStatus::CLOSED) {
     return;
   }
@@ -344,7 +688,7 @@ void WebSocketConnection::close(uint16_t code, const std::string &reason) {
   status = WebSocketConnectionStatus::CLOSING;
 
   // Send close frame
-  std::vector<uint8_t>
+  Vector<uint8_t>
       close_payload; // MEMORY ALLOCATION: vector for close payload
   // OPTIMIZATION STRATEGY: Use small stack buffer (close payload is tiny: 2
   // bytes code + reason)
@@ -355,7 +699,7 @@ void WebSocketConnection::close(uint16_t code, const std::string &reason) {
     close_payload.push_back(static_cast<uint8_t>(c));
   }
 
-  std::vector<uint8_t> frame = buildFrame(
+  Vector<uint8_t> frame = buildFrame(
       close_payload,
       WebSocketOpcode::CLOSE); // MEMORY ALLOCATION: vector for close frame
   Buffer buffer;               // MEMORY ALLOCATION: Buffer object
@@ -368,89 +712,150 @@ void WebSocketConnection::close(uint16_t code, const std::string &reason) {
   onClose(*this, code, reason);
 }
 
-void WebSocketConnection::handleSocketData(const BufferView &data) {
+void WebSocketConnection::handleSocketData(const BufferChain &data) {
   LOG("[WebSocketConnection] Processing WebSocket frame data, size: ",
-      data.size);
-  std::vector<uint8_t> frame_data(
-      data.data,
-      data.data + data.size); // MEMORY ALLOCATION: vector copy of frame data
-  // OPTIMIZATION STRATEGY: Parse directly from BufferView, no intermediate copy
-  // needed
-  parseFrame(frame_data);
-}
+      data.size());
 
-void WebSocketConnection::parseFrame(const std::vector<uint8_t> &data) {
-  if (data.size() < 2)
-    return;
+  // Stitch carried partial-frame bytes in front of the new bytes as chain
+  // segments - the fresh data is never flattened or copied up front
+  BufferChain chain;
+  if (!frame_carry.empty()) {
+    chain.append(frame_carry.data(), frame_carry.size());
+  }
+  for (size_t i = 0; i < data.segmentCount(); ++i) {
+    const BufferView &segment = data.segmentAt(i);
+    chain.append(segment.data, segment.size);
+  }
+
+  // Decode as many complete frames as arrived; coalesced frames dispatch
+  // back-to-back in one pass
+  BufferChain::Cursor cursor(chain);
+  while (cursor.remaining() > 0) {
+    BufferChain::Cursor attempt = cursor;
+#if USE_AREA_ALLOCATORS
+    // One frame area per message: temporaries the handler builds with the
+    // containers.hpp aliases bump-allocate here and the area is reset when
+    // dispatch returns. The connection's own scratch buffers keep their
+    // heap allocators (they were constructed outside any context), so
+    // nothing that outlives the message can land in the area.
+    FrameAreaScope frame_area;
+#endif
+    if (!decodeFrame(attempt, frame_scratch)) {
+      if (frame_scratch.payload_length > max_frame_size) {
+        close(1009, "frame exceeds maximum size");
+        return; // drop the tail; the connection is going away
+      }
+      break; // incomplete; cursor stays at the frame's first byte
+    }
+    cursor = attempt;
+    // Compressed data frames (RSV1) inflate into the reused scratch
+    // vector before dispatch; control frames are never compressed
+    if (frame_scratch.rsv1 && deflate && deflate->enabled &&
+        (frame_scratch.opcode == WebSocketOpcode::TEXT ||
+         frame_scratch.opcode == WebSocketOpcode::BINARY)) {
+      if (!deflate->decompress(frame_scratch.payload.data(),
+                               frame_scratch.payload.size(),
+                               inflate_scratch)) {
+        close(1002, "invalid compressed payload");
+        return;
+      }
+      frame_scratch.payload.swap(inflate_scratch);
+      frame_scratch.rsv1 = false;
+    }
+    dispatchFrame(frame_scratch);
+    if (status == WebSocketConnectionStatus::CLOSED) {
+      return; // close() ran; drop anything queued after the close frame
+    }
+  }
+
+  // Save the unconsumed tail (at most one partial frame) for the next read.
+  // Copied out before the swap because the chain may point into frame_carry.
+  size_t leftover = cursor.remaining();
+  if (leftover > 0) {
+    String tail;
+    tail.resize(leftover);
+    cursor.read(&tail[0], leftover);
+    frame_carry.swap(tail);
+  } else {
+    frame_carry.clear();
+  }
+}
 
-  WebSocketFrame frame; // MEMORY ALLOCATION: WebSocketFrame struct (contains
-                        // vector payload)
-  // OPTIMIZATION STRATEGY: Use stack-based frame parser, pre-allocate payload
-  // buffer per connection
+bool WebSocketConnection::decodeFrame(BufferChain::Cursor &cursor,
+                                      WebSocketFrame &frame) {
+  if (cursor.remaining() < 2) {
+    return false;
+  }
 
   // Parse first byte
-  frame.fin = (data[0] & 0x80) != 0;
-  frame.rsv1 = (data[0] & 0x40) != 0;
-  frame.rsv2 = (data[0] & 0x20) != 0;
-  frame.rsv3 = (data[0] & 0x10) != 0;
-  frame.opcode = static_cast<WebSocketOpcode>(data[0] & 0x0F);
+  uint8_t first_byte = cursor.next();
+  frame.fin = (first_byte & 0x80) != 0;
+  frame.rsv1 = (first_byte & 0x40) != 0;
+  frame.rsv2 = (first_byte & 0x20) != 0;
+  frame.rsv3 = (first_byte & 0x10) != 0;
+  frame.opcode = static_cast<WebSocketOpcode>(first_byte & 0x0F);
 
   // Parse second byte
-  frame.masked = (data[1] & 0x80) != 0;
-  uint8_t payload_len = data[1] & 0x7F;
-
-  size_t offset = 2;
+  uint8_t second_byte = cursor.next();
+  frame.masked = (second_byte & 0x80) != 0;
+  uint8_t payload_len = second_byte & 0x7F;
 
   // Parse extended payload length
   if (payload_len == 126) {
-    if (data.size() < offset + 2)
-      return;
-    frame.payload_length = (data[offset] << 8) | data[offset + 1];
-    offset += 2;
+    if (cursor.remaining() < 2)
+      return false;
+    frame.payload_length = cursor.next();
+    frame.payload_length = (frame.payload_length << 8) | cursor.next();
   } else if (payload_len == 127) {
-    if (data.size() < offset + 8)
-      return;
+    if (cursor.remaining() < 8)
+      return false;
     frame.payload_length = 0;
     for (int i = 0; i < 8; ++i) {
-      frame.payload_length = (frame.payload_length << 8) | data[offset + i];
+      frame.payload_length = (frame.payload_length << 8) | cursor.next();
     }
-    offset += 8;
   } else {
     frame.payload_length = payload_len;
   }
 
+  // Refuse oversize claims before buffering a single payload byte toward
+  // them; handleSocketData sees the length on the incomplete return and
+  // closes with 1009
+  if (frame.payload_length > max_frame_size) {
+    return false;
+  }
+
   // Parse masking key
   if (frame.masked) {
-    if (data.size() < offset + 4)
-      return;
-    frame.masking_key = (data[offset] << 24) | (data[offset + 1] << 16) |
-                        (data[offset + 2] << 8) | data[offset + 3];
-    offset += 4;
+    if (cursor.remaining() < 4)
+      return false;
+    frame.masking_key = 0;
+    for (int i = 0; i < 4; ++i) {
+      frame.masking_key = (frame.masking_key << 8) | cursor.next();
+    }
   }
 
-  // Parse payload
-  if (data.size() < offset + frame.payload_length)
-    return;
+  // Parse payload into the connection's reused scratch vector (resize only
+  // grows its capacity once, then frames recycle it)
+  if (cursor.remaining() < frame.payload_length)
+    return false;
 
-  frame.payload.resize(
-      frame.payload_length); // MEMORY ALLOCATION: vector resize for payload
-  // OPTIMIZATION STRATEGY: Use connection-local payload buffer, reuse across
-  // frames
-  for (size_t i = 0; i < frame.payload_length; ++i) {
-    frame.payload[i] = data[offset + i];
-    if (frame.masked) {
-      frame.payload[i] ^= ((frame.masking_key >> ((3 - (i % 4)) * 8)) & 0xFF);
-    }
+  frame.payload.resize(frame.payload_length);
+  cursor.read(frame.payload.data(), frame.payload_length);
+  if (frame.masked) {
+    wsUnmask(frame.payload.data(), frame.payload_length, frame.masking_key);
   }
+  return true;
+}
 
+void WebSocketConnection::dispatchFrame(const WebSocketFrame &frame) {
   // Handle frame based on opcode
   switch (frame.opcode) {
   case WebSocketOpcode::TEXT: {
-    std::string message(
-        frame.payload.begin(),
-        frame.payload.end()); // MEMORY ALLOCATION: string from vector
-    // OPTIMIZATION STRATEGY: Pass payload directly as string_view to avoid copy
-    onMessage(*this, message);
+    // Reused scratch string - the MessageCallback signature wants a String,
+    // so the bytes are assigned into retained capacity rather than a fresh
+    // allocation per message
+    message_scratch.assign(frame.payload.begin(), frame.payload.end());
+    onMessage(*this, message_scratch);
     break;
   }
   case WebSocketOpcode::BINARY: {
@@ -459,14 +864,14 @@ void WebSocketConnection::parseFrame(const std::vector<uint8_t> &data) {
   }
   case WebSocketOpcode::CLOSE: {
     uint16_t close_code = 1000;
-    std::string close_reason = ""; // MEMORY ALLOCATION: string for close reason
+    String close_reason = ""; // MEMORY ALLOCATION: string for close reason
     // OPTIMIZATION STRATEGY: Use string_view from payload, only allocate if
     // needed for callback
 
     if (frame.payload.size() >= 2) {
       close_code = (frame.payload[0] << 8) | frame.payload[1];
       if (frame.payload.size() > 2) {
-        close_reason = std::string(
+        close_reason = String(
             frame.payload.begin() + 2,
             frame.payload.end()); // MEMORY ALLOCATION: string from vector slice
         // OPTIMIZATION STRATEGY: Use string_view constructor from payload range
@@ -480,7 +885,7 @@ void WebSocketConnection::parseFrame(const std::vector<uint8_t> &data) {
   }
   case WebSocketOpcode::PING: {
     // Send pong response
-    std::vector<uint8_t> pong_frame = buildFrame(
+    Vector<uint8_t> pong_frame = buildFrame(
         frame.payload,
         WebSocketOpcode::PONG); // MEMORY ALLOCATION: vector for pong frame
     Buffer buffer;              // MEMORY ALLOCATION: Buffer object
@@ -492,7 +897,7 @@ void WebSocketConnection::parseFrame(const std::vector<uint8_t> &data) {
     break;
   }
   case WebSocketOpcode::PONG: {
-    // Handle pong (could implement ping/pong tracking here)
+    missed_pongs = 0; // liveness confirmed for the heartbeat sweep
     break;
   }
   default:
@@ -500,25 +905,29 @@ void WebSocketConnection::parseFrame(const std::vector<uint8_t> &data) {
   }
 }
 
-std::vector<uint8_t> WebSocketConnection::buildFrame(const std::string &message,
-                                                     WebSocketOpcode opcode) {
-  std::vector<uint8_t> data(
+Vector<uint8_t> WebSocketConnection::buildFrame(const String &message,
+                                                     WebSocketOpcode opcode,
+                                                     bool compressed) {
+  Vector<uint8_t> data(
       message.begin(), message.end()); // MEMORY ALLOCATION: vector from string
   // OPTIMIZATION STRATEGY: Build frame directly from string data, avoid
   // intermediate vector
-  return buildFrame(data, opcode);
+  return buildFrame(data, opcode, compressed);
 }
 
-std::vector<uint8_t>
-WebSocketConnection::buildFrame(const std::vector<uint8_t> &data,
-                                WebSocketOpcode opcode) {
-  std::vector<uint8_t>
+Vector<uint8_t>
+WebSocketConnection::buildFrame(const Vector<uint8_t> &data,
+                                WebSocketOpcode opcode, bool compressed) {
+  Vector<uint8_t>
       frame; // MEMORY ALLOCATION: vector for frame construction
   // OPTIMIZATION STRATEGY: Use thread-local pre-sized frame buffer, calculate
   // exact size upfront
 
-  // First byte: FIN + RSV + Opcode
+  // First byte: FIN + RSV + Opcode (RSV1 marks permessage-deflate payloads)
   uint8_t first_byte = 0x80; // FIN bit set
+  if (compressed) {
+    first_byte |= 0x40;
+  }
   first_byte |= static_cast<uint8_t>(opcode);
   frame.push_back(first_byte);
 
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "containers.hpp"
+#include "inplace_function.hpp"
 #include "listener.hpp"
 #include "socket.hpp"
+#include "ws_deflate.hpp"
+#include <deque>
 #include <functional>
+#include <memory>
 
-// Forward declaration
+// Forward declarations
 struct HttpServer;
+struct HttpRequest;
 
 enum class WebSocketOpcode {
   CONTINUATION = 0x0,
@@ -37,12 +42,59 @@ struct WebSocketConnection {
   String path = "";
   StringMap<String> headers = {};
 
-  using MessageCallback = Function<void(WebSocketConnection &, const String &)>;
+  // Bytes of an incomplete frame carried over between reads - a frame whose
+  // header or payload straddles a recv boundary resumes from here instead
+  // of being dropped. Empty whenever reads end on a frame boundary.
+  String frame_carry = "";
+
+  // Largest frame payload accepted from the peer; a claimed length beyond
+  // it closes with 1009 (Message Too Big). Without a bound, a peer
+  // declaring a 2^62-byte frame would have every byte it ever sends saved
+  // into frame_carry toward a frame that never completes. Matches
+  // WsDeflateContext::max_message_size, which bounds the inflated side.
+  size_t max_frame_size = 16 * 1024 * 1024;
+
+  // Reused across frames so the payload vector and message string keep
+  // their capacity - no per-frame allocation at steady state
+  WebSocketFrame frame_scratch = {};
+  String message_scratch = "";
+
+  // permessage-deflate state, set during the upgrade when the client's
+  // offer was accepted; null on uncompressed connections
+  std::shared_ptr<WsDeflateContext> deflate = nullptr;
+  Vector<uint8_t> inflate_scratch = {};
+
+  // Send backpressure. Once the socket's queued bytes reach high_watermark,
+  // further messages park in the overflow queue (sendText/sendBinary return
+  // false to tell the producer to slow down); with drop_oldest set, the
+  // oldest parked message is discarded instead of letting the queue grow -
+  // the policy for latency-critical topics where stale data is worthless.
+  // onDrain fires once the write path falls back below low_watermark and
+  // the overflow queue has been flushed.
+  size_t high_watermark = 1024 * 1024;
+  size_t low_watermark = 256 * 1024;
+  bool drop_oldest = false;
+  size_t dropped_messages = 0; // total discarded by drop_oldest
+  std::deque<Vector<uint8_t>> overflow = {};
+  size_t overflow_bytes = 0;
+
+  // Heartbeat bookkeeping - two counters instead of a per-connection timer
+  // entry. ping_epoch is the server sweep that last pinged this connection;
+  // missed_pongs resets whenever any pong arrives.
+  uint32_t ping_epoch = 0;
+  uint32_t missed_pongs = 0;
+
+  using DrainCallback = InplaceFunction<void(WebSocketConnection &)>;
+  DrainCallback onDrain = nullptr;
+
+  using MessageCallback =
+      InplaceFunction<void(WebSocketConnection &, const String &)>;
   using BinaryCallback =
-      Function<void(WebSocketConnection &, const Vector<uint8_t> &)>;
-  using CloseCallback = Function<void(WebSocketConnection &, uint16_t code,
-                                      const String &reason)>;
-  using ErrorCallback = Function<void(WebSocketConnection &, const String &)>;
+      InplaceFunction<void(WebSocketConnection &, const Vector<uint8_t> &)>;
+  using CloseCallback = InplaceFunction<void(
+      WebSocketConnection &, uint16_t code, const String &reason)>;
+  using ErrorCallback =
+      InplaceFunction<void(WebSocketConnection &, const String &)>;
 
   MessageCallback onMessage = [](WebSocketConnection &, const String &) {};
   BinaryCallback onBinary = [](WebSocketConnection &, const Vector<uint8_t> &) {
@@ -51,26 +103,76 @@ struct WebSocketConnection {
   };
   ErrorCallback onError = [](WebSocketConnection &, const String &) {};
 
-  // WebSocket connection methods
-  void sendText(const String &message);
-  void sendBinary(const Vector<uint8_t> &data);
+  // Return the connection to its freshly-constructed state while keeping
+  // the capacity of every scratch buffer - slab slots recycle through this
+  // instead of destroy-and-reconstruct, so reuse allocates nothing
+  void reset();
+
+  // WebSocket connection methods. Send calls return false when the write
+  // path is at or over high_watermark (the message is still queued, or
+  // dropped-oldest per policy) - the producer's cue to pause until onDrain.
+  bool sendText(const String &message);
+  bool sendBinary(const Vector<uint8_t> &data);
   void close(uint16_t code = 1000, const String &reason = "");
 
-  // Internal methods
-  void handleSocketData(const BufferView &data);
-  void parseFrame(const Vector<uint8_t> &data);
-  Vector<uint8_t> buildFrame(const String &message, WebSocketOpcode opcode);
-  Vector<uint8_t> buildFrame(const Vector<uint8_t> &data,
-                             WebSocketOpcode opcode);
+  // Queue one framed message, parking it in overflow past the watermark
+  bool queueFrame(Vector<uint8_t> frame);
+
+  // Move parked messages onto the socket as capacity frees up (called from
+  // the socket's drain callback)
+  void flushOverflow();
+
+  // Internal methods: handleSocketData stitches carried bytes in front of
+  // the new chain, decodes as many complete frames as arrived (decodeFrame
+  // leaves the cursor untouched on an incomplete one), and saves the tail
+  void handleSocketData(const BufferChain &data);
+  bool decodeFrame(BufferChain::Cursor &cursor, WebSocketFrame &frame);
+  void dispatchFrame(const WebSocketFrame &frame);
+  static Vector<uint8_t> buildFrame(const String &message,
+                                    WebSocketOpcode opcode,
+                                    bool compressed = false);
+  static Vector<uint8_t> buildFrame(const Vector<uint8_t> &data,
+                                    WebSocketOpcode opcode,
+                                    bool compressed = false);
 };
 
 struct WebSocketServer {
   Listener *listener = nullptr;
   HashMap<String, Function<void(WebSocketConnection &)>> routes = {};
-  HashMap<Socket *, WebSocketConnection> connections = {};
-
-  using ConnectionCallback = Function<void(WebSocketConnection &)>;
-  using DisconnectionCallback = Function<void(WebSocketConnection &)>;
+  // Connections live in a stable slab addressed by the index bits of the
+  // socket's PollableID (the same slot-map direction as pollable_pool.hpp):
+  // lookup is one array indexation plus an owner check, no rehash ever moves
+  // a live connection out from under a handler, and a vacated slot is reset
+  // in place so its scratch buffers keep their capacity. The stored owner ID
+  // carries the generation bits, so a recycled socket slot never matches a
+  // stale connection. std::deque keeps slot addresses stable across growth.
+  struct ConnectionSlot {
+    WebSocketConnection conn = {};
+    PollableID owner = 0; // full ID including the generation bits
+    bool occupied = false;
+  };
+  std::deque<ConnectionSlot> connection_slots = {};
+  size_t connection_count = 0;
+
+  // permessage-deflate negotiation: accepted whenever the client offers it
+  // unless disabled here. no_context_takeover additionally requests both
+  // sides reset their compression window per message, bounding the ~32KB
+  // of zlib state each direction otherwise retains per connection.
+  bool permessage_deflate = true;
+  bool no_context_takeover = false;
+
+  // Heartbeat manager: one shared interval timer sweeps every connection,
+  // sending pings from a single preserialized refcounted frame and closing
+  // peers that miss heartbeat_max_missed consecutive pongs. Scales to tens
+  // of thousands of connections without one TimerEntry (and its
+  // std::function) apiece.
+  uint32_t heartbeat_timer = 0; // Poller::TimerID, 0 while not enabled
+  uint32_t heartbeat_max_missed = 2;
+  uint32_t heartbeat_epoch = 0; // increments once per sweep
+  std::shared_ptr<const std::string> heartbeat_ping = nullptr;
+
+  using ConnectionCallback = InplaceFunction<void(WebSocketConnection &)>;
+  using DisconnectionCallback = InplaceFunction<void(WebSocketConnection &)>;
 
   ConnectionCallback onConnection = [](WebSocketConnection &) {};
   DisconnectionCallback onDisconnection = [](WebSocketConnection &) {};
@@ -82,19 +184,71 @@ struct WebSocketServer {
   // Route handling
   void route(const String &path, Function<void(WebSocketConnection &)> handler);
 
-  // Connection management
+  // Fan a text message out to every open connection on `path` (empty path
+  // matches all connections). The frame is serialized exactly once into a
+  // refcounted buffer; each subscriber queues a pointer to it, so a 10k-way
+  // broadcast costs one serialization plus n pointer pushes.
+  void broadcast(const String &path, const String &message);
+
+  // Start (or retune) the shared heartbeat timer: ping every open
+  // connection each interval_ms and close peers after max_missed unanswered
+  // pings
+  void enableHeartbeat(uint32_t interval_ms, uint32_t max_missed = 2);
+  void sweepHeartbeats();
+
+  // Connection management: slot lookup returns null for sockets without a
+  // live connection (vacant slot or stale generation)
   WebSocketConnection &createConnection(Socket &socket);
+  WebSocketConnection *findConnection(Socket &socket);
+  void releaseConnection(Socket &socket);
+
+  // Move an OPEN connection to another poller's WebSocketServer (shard
+  // rebalancing). The socket hops loops through Poller::migrate - same fd,
+  // queued bytes intact - and the connection state (negotiated deflate
+  // context, watermarks, parked overflow, partial-frame carry) lands in a
+  // slot of target_server, whose route handler for the path is re-run on
+  // the target thread so the message callbacks come from the adopting
+  // server (onConnection is not re-fired - the connection is not new).
+  // Source poller thread only; returns false unless the connection is OPEN.
+  bool migrateConnection(WebSocketConnection &conn, Poller &target,
+                         WebSocketServer &target_server);
+
+  // Shared-port path: adopt an upgrade request HttpServer's incremental
+  // parser already decoded. The parsed method/path/headers feed the
+  // handshake directly - the bytes are never parsed a second time, which
+  // makes HTTP+WS port sharing cost the same as a dedicated WS listener.
+  // The caller has already verified the request is a WebSocket upgrade.
+  void adoptUpgrade(Socket &socket, const HttpRequest &request);
 
   // Internal methods
   void handleConnection(Socket &socket);
+  // Install the frame/upgrade data handler on a socket (split out of
+  // handleConnection so a migrated socket gets the same wiring on adoption)
+  void attachDataHandler(Socket &socket);
+  // Install the OPEN-state socket hooks (drain, close) and the connection's
+  // default routing callbacks (split out of upgradeToWebSocket, shared with
+  // the migrateConnection adopt path)
+  void attachOpenHandlers(Socket &socket, WebSocketConnection *conn);
   void handleHttpRequest(Socket &socket, const String &data,
                          WebSocketConnection *conn);
   bool parseHttpRequest(const String &data, String &method, String &path,
                         StringMap<String> &headers);
   bool isWebSocketUpgrade(const StringMap<String> &headers);
   String generateAcceptKey(const String &key);
-  String buildHandshakeResponse(const String &accept_key);
+  String buildHandshakeResponse(const String &accept_key,
+                                const String &extensions);
+
+  // Parse the client's Sec-WebSocket-Extensions offer, set up the
+  // connection's deflate context, and return the response header line
+  // (empty when nothing was negotiated)
+  String negotiateExtensions(const String &offer, WebSocketConnection *conn);
   void upgradeToWebSocket(Socket &socket, const String &path,
                           const StringMap<String> &headers,
                           WebSocketConnection *conn);
+  // Handshake core shared by the raw-listener path (upgradeToWebSocket)
+  // and the pre-parsed adoptUpgrade path: accept key, extension
+  // negotiation, 101 response, connection wiring, route dispatch. The
+  // caller has already stored the headers on the connection.
+  void completeUpgrade(Socket &socket, const String &path, const String &key,
+                       const String &ext_offer, WebSocketConnection *conn);
 };
\ No newline at end of file
@@ -44,13 +44,13 @@ int main() {
     LOG("[Echo Route] Setting up echo handlers for connection");
 
     conn.onMessage = [](WebSocketConnection &connection,
-                        const std::string &message) {
+                        const String &message) {
       LOG("[Echo] Received text message: ", message);
       connection.sendText(message);
     };
 
     conn.onBinary = [](WebSocketConnection &connection,
-                       const std::vector<uint8_t> &data) {
+                       const Vector<uint8_t> &data) {
       LOG("[Echo] Received binary message of size: ", data.size());
       connection.sendBinary(data);
     };
@@ -61,7 +61,7 @@ int main() {
     LOG("[Chat Route] Setting up chat handlers for connection");
 
     conn.onMessage = [](WebSocketConnection &connection,
-                        const std::string &message) {
+                        const String &message) {
       LOG("[Chat] Received message: ", message);
       connection.sendText("Chat response: " + message);
     };
@@ -0,0 +1,100 @@
+#include "ws_deflate.hpp"
+#include <cstring>
+
+// Raw deflate (negative windowBits): permessage-deflate frames carry no
+// zlib header or checksum
+static constexpr int WS_DEFLATE_WINDOW_BITS = -15;
+
+WsDeflateContext::~WsDeflateContext() {
+  if (deflate_ready) {
+    deflateEnd(&deflate_stream);
+  }
+  if (inflate_ready) {
+    inflateEnd(&inflate_stream);
+  }
+}
+
+bool WsDeflateContext::compress(const uint8_t *data, size_t len,
+                                Vector<uint8_t> &out) {
+  if (!deflate_ready) {
+    memset(&deflate_stream, 0, sizeof(deflate_stream));
+    if (deflateInit2(&deflate_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     WS_DEFLATE_WINDOW_BITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+    deflate_ready = true;
+  }
+
+  out.clear();
+  deflate_stream.next_in = const_cast<Bytef *>(data);
+  deflate_stream.avail_in = static_cast<uInt>(len);
+
+  // Z_SYNC_FLUSH ends the output with an empty stored block (00 00 FF FF)
+  // and leaves the stream resumable for the next message
+  uint8_t chunk[16 * 1024];
+  do {
+    deflate_stream.next_out = chunk;
+    deflate_stream.avail_out = sizeof(chunk);
+    if (deflate(&deflate_stream, Z_SYNC_FLUSH) != Z_OK) {
+      return false;
+    }
+    out.insert(out.end(), chunk, chunk + sizeof(chunk) - deflate_stream.avail_out);
+  } while (deflate_stream.avail_out == 0);
+
+  // Strip the flush tail; the peer re-appends it before inflating
+  if (out.size() < 4) {
+    return false;
+  }
+  out.resize(out.size() - 4);
+
+  if (server_no_context_takeover) {
+    deflateReset(&deflate_stream);
+  }
+  return true;
+}
+
+bool WsDeflateContext::decompress(const uint8_t *data, size_t len,
+                                  Vector<uint8_t> &out) {
+  if (!inflate_ready) {
+    memset(&inflate_stream, 0, sizeof(inflate_stream));
+    if (inflateInit2(&inflate_stream, WS_DEFLATE_WINDOW_BITS) != Z_OK) {
+      return false;
+    }
+    inflate_ready = true;
+  }
+
+  out.clear();
+  static const uint8_t tail[4] = {0x00, 0x00, 0xFF, 0xFF};
+
+  // Payload first, then the re-appended flush tail
+  const uint8_t *inputs[2] = {data, tail};
+  size_t input_sizes[2] = {len, sizeof(tail)};
+
+  uint8_t chunk[16 * 1024];
+  for (int pass = 0; pass < 2; ++pass) {
+    inflate_stream.next_in = const_cast<Bytef *>(inputs[pass]);
+    inflate_stream.avail_in = static_cast<uInt>(input_sizes[pass]);
+    while (inflate_stream.avail_in > 0) {
+      inflate_stream.next_out = chunk;
+      inflate_stream.avail_out = sizeof(chunk);
+      int res = inflate(&inflate_stream, Z_NO_FLUSH);
+      if (res != Z_OK && res != Z_BUF_ERROR) {
+        return false;
+      }
+      out.insert(out.end(), chunk,
+                 chunk + sizeof(chunk) - inflate_stream.avail_out);
+      if (out.size() > max_message_size) {
+        return false; // refuse to inflate further
+      }
+      if (res == Z_BUF_ERROR && inflate_stream.avail_out == sizeof(chunk)) {
+        break; // no progress possible with this input
+      }
+    }
+  }
+
+  if (client_no_context_takeover) {
+    inflateReset(&inflate_stream);
+  }
+  return true;
+}
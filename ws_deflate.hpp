@@ -0,0 +1,34 @@
+#pragma once
+
+#include "containers.hpp"
+#include <zlib.h>
+
+// Per-connection compression state for the permessage-deflate WebSocket
+// extension (RFC 7692). Each direction keeps its own raw-deflate z_stream,
+// initialized lazily on first use and reused message after message so the
+// LZ77 window carries across messages (context takeover). Either side's
+// no_context_takeover flag resets the stream after every message instead,
+// trading ratio for bounded per-connection memory.
+struct WsDeflateContext {
+  bool enabled = false;
+  bool server_no_context_takeover = false;
+  bool client_no_context_takeover = false;
+
+  z_stream deflate_stream = {};
+  z_stream inflate_stream = {};
+  bool deflate_ready = false;
+  bool inflate_ready = false;
+
+  // Cap on a single decompressed message (decompression-bomb guard)
+  size_t max_message_size = 16 * 1024 * 1024;
+
+  ~WsDeflateContext();
+
+  // Raw-deflate `len` bytes into `out` with the trailing 00 00 FF FF
+  // stripped, as the wire format requires. Returns false on zlib failure.
+  bool compress(const uint8_t *data, size_t len, Vector<uint8_t> &out);
+
+  // Inverse: re-append the empty-block tail and inflate into `out`.
+  // Returns false on corrupt input or when max_message_size is exceeded.
+  bool decompress(const uint8_t *data, size_t len, Vector<uint8_t> &out);
+};